@@ -31,6 +31,19 @@ void App::processEvents() {
                 case sf::Keyboard::Scancode::Delete:
                     simulator.deleteSelectedGates();
                     break;
+                case sf::Keyboard::Scancode::Equal:
+                case sf::Keyboard::Scancode::NumpadPlus:
+                    simulator.changeInputCount(1);
+                    break;
+                case sf::Keyboard::Scancode::Hyphen:
+                case sf::Keyboard::Scancode::NumpadMinus:
+                    simulator.changeInputCount(-1);
+                    break;
+                case sf::Keyboard::Scancode::M:
+                    if (const int definition = simulator.packageSelection(); definition >= 0) {
+                        palette.addModule(simulator.getModuleName(definition), definition);
+                    }
+                    break;
                 case sf::Keyboard::Scancode::Q:
                     window.close();
                     break;
@@ -41,7 +54,7 @@ void App::processEvents() {
 
         canvas.handleEvent(*event, window);
         palette.handleEvent(*event, window);
-        simulator.handleEvent(*event, window, canvas.getView(), palette.getSelectedGateType());
+        simulator.handleEvent(*event, window, canvas.getView(), palette.getSelectedGateType(), palette.getSelectedModule());
     }
 }
 
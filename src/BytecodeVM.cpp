@@ -0,0 +1,108 @@
+#include "BytecodeVM.hpp"
+
+#if defined(__GNUC__)
+#define BYTECODE_COMPUTED_GOTO 1
+#endif
+
+void BytecodeVM::clear() {
+    code.clear();
+    instructionCount = 0;
+}
+
+void BytecodeVM::assemble(const std::vector<WordOp>& program) {
+    // Opcodes follow WordOpCode, shifted by one for HALT.
+    static const uint8_t operandCounts[] = {1, 1, 2, 2, 3, 3, 3, 3, 3};
+    static_assert(static_cast<uint32_t>(WordOpCode::NOR) + 1 == NOR, "Opcode must mirror WordOpCode");
+
+    code.resize(program.size() * 4 + 1);
+    uint32_t* out = code.data();
+    for (const WordOp& op : program) {
+        const uint8_t operands = operandCounts[static_cast<size_t>(op.code)];
+        *out++ = static_cast<uint32_t>(op.code) + 1;
+        *out++ = op.dst;
+        if (operands >= 2) *out++ = op.a;
+        if (operands >= 3) *out++ = op.b;
+    }
+    *out++ = HALT;
+
+    code.resize(out - code.data());
+    instructionCount = program.size();
+}
+
+template <typename Word>
+void BytecodeVM::execute(Word* regs, Word ones) const {
+    if (code.empty()) return;
+    const uint32_t* pc = code.data();
+
+#ifdef BYTECODE_COMPUTED_GOTO
+    static const void* labels[] = {&&op_HALT, &&op_ZERO, &&op_ONES, &&op_COPY, &&op_NOT, &&op_AND, &&op_OR, &&op_XOR, &&op_NAND, &&op_NOR};
+#define DISPATCH() goto* labels[*pc++]
+#define CASE(name) op_##name:
+
+    DISPATCH();
+#else
+#define DISPATCH() continue
+#define CASE(name) case name:
+
+    for (;;) switch (*pc++) {
+#endif
+
+    CASE(ZERO) {
+        regs[pc[0]] = 0;
+        pc += 1;
+        DISPATCH();
+    }
+    CASE(ONES) {
+        regs[pc[0]] = ones;
+        pc += 1;
+        DISPATCH();
+    }
+    CASE(COPY) {
+        regs[pc[0]] = regs[pc[1]];
+        pc += 2;
+        DISPATCH();
+    }
+    CASE(NOT) {
+        regs[pc[0]] = regs[pc[1]] ^ ones;
+        pc += 2;
+        DISPATCH();
+    }
+    CASE(AND) {
+        regs[pc[0]] = regs[pc[1]] & regs[pc[2]];
+        pc += 3;
+        DISPATCH();
+    }
+    CASE(OR) {
+        regs[pc[0]] = regs[pc[1]] | regs[pc[2]];
+        pc += 3;
+        DISPATCH();
+    }
+    CASE(XOR) {
+        regs[pc[0]] = regs[pc[1]] ^ regs[pc[2]];
+        pc += 3;
+        DISPATCH();
+    }
+    CASE(NAND) {
+        regs[pc[0]] = (regs[pc[1]] & regs[pc[2]]) ^ ones;
+        pc += 3;
+        DISPATCH();
+    }
+    CASE(NOR) {
+        regs[pc[0]] = (regs[pc[1]] | regs[pc[2]]) ^ ones;
+        pc += 3;
+        DISPATCH();
+    }
+    CASE(HALT) return;
+
+#ifndef BYTECODE_COMPUTED_GOTO
+        default:
+            return;
+    }
+#endif
+
+#undef DISPATCH
+#undef CASE
+}
+
+template void BytecodeVM::execute<uint8_t>(uint8_t* regs, uint8_t ones) const;
+template void BytecodeVM::execute<uint64_t>(uint64_t* regs, uint64_t ones) const;
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SimdKernels.hpp"
+
+// Register-based bytecode for a levelized WordOp program. Every gate is one
+// register; an instruction is an opcode word followed by only the operands it
+// needs (dst, or dst a, or dst a b), and the stream ends with HALT so the
+// interpreter loop needs no bounds check. Dispatch uses computed goto where
+// the compiler supports it and a switch otherwise.
+class BytecodeVM {
+   public:
+    enum Opcode : uint32_t { HALT, ZERO, ONES, COPY, NOT, AND, OR, XOR, NAND, NOR };
+
+   private:
+    std::vector<uint32_t> code;
+    size_t instructionCount = 0;
+
+    template <typename Word>
+    void execute(Word* regs, Word ones) const;
+
+   public:
+    void assemble(const std::vector<WordOp>& program);
+    void clear();
+
+    // One boolean evaluation over 0/1 registers.
+    void run(uint8_t* regs) const { execute<uint8_t>(regs, 1); }
+    // 64 evaluations at once, one per bit.
+    void run(uint64_t* regs) const { execute<uint64_t>(regs, ~0ULL); }
+
+    bool empty() const { return instructionCount == 0; }
+    size_t getInstructionCount() const { return instructionCount; }
+    const std::vector<uint32_t>& getCode() const { return code; }
+};
@@ -15,6 +15,8 @@ Canvas::Canvas(Simulator &simulator) : simulator(simulator) {
 
 void Canvas::handleEvent(const sf::Event &event, const sf::RenderWindow &window) {
     if (const auto *wheel = event.getIf<sf::Event::MouseWheelScrolled>()) {
+        // The palette scrolls instead under the cursor.
+        if (wheel->position.x <= window.getSize().x * 0.18f) return;
         float factor = (wheel->delta > 0) ? 0.95f : 1.05f;
         view.setSize(view.getSize() * factor);
         return;
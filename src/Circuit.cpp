@@ -4,65 +4,282 @@
 
 #include "Gate.hpp"
 
-void Circuit::setFont(const sf::Font& font) {
-    currentFont = &font;
-    for (auto& gate : gates) {
-        gate.setFont(font);
+namespace {
+
+// Editor output pin -1 - k of a module is netlist source pin k.
+int netlistPin(int pin) { return pin < -1 ? -1 - pin : pin; }
+
+}  // namespace
+
+void Circuit::markEdited() {
+    netlistDirty = true;
+    loopsSettled = false;
+    ++revision;
+}
+
+void Circuit::invalidateTopology() {
+    markEdited();
+    compiled.invalidate();
+}
+
+const Netlist& Circuit::getNetlist() const {
+    if (netlistDirty) {
+        // Live gates in slot order; netlistSlots maps them back to slots.
+        Netlist& editor = instances.empty() ? netlist : editorNetlist;
+        editor.clear();
+        netlistSlots.clear();
+        netlistIndex.assign(gates.slotCount(), SIZE_MAX);
+        for (size_t slot = 0; slot < gates.slotCount(); ++slot) {
+            if (!gates.contains(slot)) continue;
+            auto it = instances.find(slot);
+            netlistIndex[slot] = it == instances.end() ? editor.addGate(gates[slot].getType(), gates[slot].getPersistentLabel())
+                                                       : editor.addModule(it->second.definition, "U" + std::to_string(slot));
+            netlistSlots.push_back(slot);
+        }
+        for (size_t slot = 0; slot < nets.slotCount(); ++slot) {
+            if (!nets.contains(slot)) continue;
+            const Net& net = nets[slot];
+            for (const Net::Sink& sink : net.getSinks()) {
+                editor.addConnection(netlistIndex[net.getDriverGate()], netlistPin(net.getDriverPin()), netlistIndex[sink.gate], sink.pin);
+            }
+        }
+        stateSlotCount = gates.slotCount();
+
+        if (!instances.empty()) {
+            // Other gates keep their order and each body takes its instance's
+            // place in the flat netlist, but the bodies get the slots after
+            // the editor's, one contiguous slice per instance.
+            const std::vector<size_t> editorSlots = std::move(netlistSlots);
+            std::vector<InstanceRange> ranges;
+            modules.flatten(editorNetlist, netlist, &ranges);
+            netlistSlots.assign(netlist.getGateCount(), SIZE_MAX);
+            size_t flat = 0;
+            auto range = ranges.begin();
+            for (size_t g = 0; g < editorSlots.size(); ++g) {
+                const size_t slot = editorSlots[g];
+                if (range == ranges.end() || range->gate != g) {
+                    netlistSlots[flat] = slot;
+                    netlistIndex[slot] = flat++;
+                    continue;
+                }
+                for (size_t i = 0; i < range->gateCount; ++i) netlistSlots[flat + i] = stateSlotCount + i;
+                netlistIndex[slot] = SIZE_MAX;
+                range->gate = slot;
+                range->firstGate = stateSlotCount;
+                stateSlotCount += range->gateCount;
+                flat += range->gateCount;
+                ++range;
+            }
+            for (InstanceRange& instance : ranges) {
+                for (size_t& gate : instance.outputGates) {
+                    if (gate != SIZE_MAX) gate = netlistSlots[gate];
+                }
+                instances.at(instance.gate).state = std::move(instance);
+            }
+        }
+        netlistDirty = false;
     }
+    return netlist;
 }
 
-void Circuit::deselectAllGates() {
-    for (auto& gate : gates) {
-        gate.setSelected(false);
+void Circuit::compile() {
+    const Netlist& current = getNetlist();
+    compiled.compile(current, netlistSlots, stateSlotCount);
+    // Module bodies start from zero whenever they are laid out again.
+    netStates.resize(stateSlotCount, 0);
+    std::fill(netStates.begin() + std::min(gates.slotCount(), netStates.size()), netStates.end(), 0);
+    netStatesValid = false;
+}
+
+void Circuit::growSlots(size_t slot) {
+    if (slot >= drivenNet.size()) {
+        drivenNet.resize(slot + 1, NO_NET);
+        sinkNets.resize(slot + 1);
     }
+    if (slot >= netStates.size()) netStates.resize(slot + 1, 0);
+    netStates[slot] = 0;
 }
-void Circuit::addGate(GateType type, sf::Vector2f position) {
-    if (gates.size() >= 100) {
-        return;
+
+uint32_t& Circuit::drivenNetOf(size_t gate, int pin) {
+    if (pin < 0) {
+        auto it = instances.find(gate);
+        const size_t output = static_cast<size_t>(-1 - pin);
+        if (it != instances.end() && output < it->second.outputNets.size()) return it->second.outputNets[output];
     }
+    return drivenNet[gate];
+}
 
-    if (type == GateType::INPUT && inputCounter >= 4) {
-        return;
+size_t Circuit::stateSlotOf(size_t gate, int pin) const {
+    auto it = instances.find(gate);
+    if (it == instances.end()) return gate;
+    const std::vector<size_t>& outputs = it->second.state.outputGates;
+    const size_t output = pin < -1 ? static_cast<size_t>(-1 - pin) : 0;
+    return output < outputs.size() ? outputs[output] : SIZE_MAX;
+}
+
+bool Circuit::readState(size_t gate, int pin) const {
+    const size_t slot = stateSlotOf(gate, pin);
+    return slot < netStates.size() && netStates[slot];
+}
+
+size_t Circuit::ownerOf(size_t slot) const {
+    if (gates.contains(slot)) return slot;
+    for (const auto& [gate, instance] : instances) {
+        if (slot >= instance.state.firstGate && slot - instance.state.firstGate < instance.state.gateCount) return gate;
     }
+    return SIZE_MAX;
+}
 
-    if (type == GateType::OUTPUT && outputCounter >= 2) {
-        return;
+int Circuit::takeLabel(std::set<int>& freeLabels, int& nextLabel) {
+    if (freeLabels.empty()) return nextLabel++;
+    const int label = *freeLabels.begin();
+    freeLabels.erase(freeLabels.begin());
+    return label;
+}
+
+void Circuit::setFont(const sf::Font& font) {
+    currentFont = &font;
+    for (size_t slot = 0; slot < gates.slotCount(); ++slot) {
+        if (gates.contains(slot)) gates[slot].setFont(font);
     }
+}
 
+void Circuit::deselectAllGates() {
+    for (size_t slot = 0; slot < gates.slotCount(); ++slot) {
+        if (gates.contains(slot)) gates[slot].setSelected(false);
+    }
+}
+GateHandle Circuit::addGate(GateType type, sf::Vector2f position) {
     int label = -1;
     if (type == GateType::INPUT) {
-        label = nextInputLabel++;
-        ++inputCounter;
+        label = takeLabel(freeInputLabels, nextInputLabel);
     } else if (type == GateType::OUTPUT) {
-        label = nextOutputLabel++;
-        ++outputCounter;
+        label = takeLabel(freeOutputLabels, nextOutputLabel);
     }
 
     try {
-        gates.emplace_back(type, position, label);
+        const GateHandle handle = gates.insert(Gate(type, position, label));
+        const size_t slot = handle.index;
         if (currentFont) {
-            gates.back().setFont(*currentFont);
+            gates[slot].setFont(*currentFont);
+        }
+
+        growSlots(slot);
+        markEdited();
+        // Module bodies sit in the slots past the editor's, so with any
+        // instance placed the compiled circuit is rebuilt, not patched.
+        if (!instances.empty()) {
+            compiled.invalidate();
+        } else if (compiled.isCompiled()) {
+            compiled.addGate(type, slot);
+            if (netStatesValid) pendingGates.push_back(slot);
         }
+        return handle;
     } catch (const std::exception& e) {
         if (type == GateType::INPUT) {
-            --inputCounter;
-            --nextInputLabel;
+            freeInputLabels.insert(label);
         } else if (type == GateType::OUTPUT) {
-            --outputCounter;
-            --nextOutputLabel;
+            freeOutputLabels.insert(label);
         }
+        return {};
     }
 }
 
-void Circuit::addWire(size_t srcGate, int srcPin, size_t dstGate, int dstPin) { wires.emplace_back(srcGate, srcPin, dstGate, dstPin); }
+GateHandle Circuit::addModule(size_t definition, sf::Vector2f position) {
+    if (definition >= modules.size()) return {};
+    const Netlist& pins = modules.getDefinition(definition);
+    const size_t outputCount = pins.getOutputGates().size();
+
+    try {
+        const GateHandle handle =
+            gates.insert(Gate(modules.getName(definition), position, static_cast<int>(pins.getInputGates().size()), static_cast<int>(outputCount)));
+        const size_t slot = handle.index;
+        if (currentFont) {
+            gates[slot].setFont(*currentFont);
+        }
+        growSlots(slot);
+        instances[slot] = {definition, std::vector<uint32_t>(outputCount, NO_NET), {}};
+        invalidateTopology();
+        return handle;
+    } catch (const std::exception& e) {
+        return {};
+    }
+}
+
+int Circuit::defineModule(const std::string& name, const std::vector<GateHandle>& members) {
+    std::vector<size_t> slots;
+    for (GateHandle handle : members) {
+        if (gates.contains(handle)) slots.push_back(handle.index);
+    }
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+    Netlist definition;
+    std::unordered_map<size_t, size_t> indexOf;
+    int inputCount = 0;
+    int outputCount = 0;
+    for (size_t slot : slots) {
+        const Gate& gate = gates[slot];
+        auto it = instances.find(slot);
+        indexOf[slot] = it == instances.end() ? definition.addGate(gate.getType(), gate.getPersistentLabel(), "g" + std::to_string(slot))
+                                              : definition.addModule(it->second.definition, "U" + std::to_string(slot));
+        inputCount += gate.getType() == GateType::INPUT;
+        outputCount += gate.getType() == GateType::OUTPUT;
+    }
+    if (outputCount == 0 || inputCount > MAX_GATE_INPUTS || outputCount > MAX_GATE_INPUTS) return -1;
+
+    for (size_t slot = 0; slot < nets.slotCount(); ++slot) {
+        if (!nets.contains(slot) || !indexOf.count(nets[slot].getDriverGate())) continue;
+        const Net& net = nets[slot];
+        for (const Net::Sink& sink : net.getSinks()) {
+            if (indexOf.count(sink.gate)) definition.addConnection(indexOf[net.getDriverGate()], netlistPin(net.getDriverPin()), indexOf[sink.gate], sink.pin);
+        }
+    }
+    return modules.define(name, definition);
+}
+
+void Circuit::addWire(size_t srcGate, int srcPin, size_t dstGate, int dstPin) {
+    if (!gates.contains(srcGate) || !gates.contains(dstGate)) return;
+
+    // Further wires from the same output join its net as extra sinks.
+    uint32_t& driven = drivenNetOf(srcGate, srcPin);
+    uint32_t net = driven;
+    if (net == NO_NET) {
+        const Gate& src = gates[srcGate];
+        const sf::Vector2f start = srcPin < 0 ? src.getOutputPinPosition(-1 - srcPin) : src.getInputPinPosition(srcPin);
+        net = nets.insert(Net(srcGate, srcPin, start)).index;
+        nets[net].setState(readState(srcGate, srcPin));
+        driven = net;
+    }
+    const Gate& dst = gates[dstGate];
+    nets[net].addSink(dstGate, dstPin, dstPin == -1 ? dst.getOutputPinPosition() : dst.getInputPinPosition(dstPin));
+    sinkNets[dstGate].push_back(net);
+
+    // Only the new wire's fan-out cone is re-levelized and re-evaluated.
+    markEdited();
+    if (!instances.empty()) {
+        compiled.invalidate();
+    } else if (compiled.isCompiled()) {
+        compiled.addConnection(srcGate, dstGate, dstPin);
+        pendingGates.push_back(dstGate);
+    }
+}
 
 void Circuit::clearCircuit() {
     gates.clear();
-    wires.clear();
-    inputCounter = 0;
-    outputCounter = 0;
+    nets.clear();
+    drivenNet.clear();
+    sinkNets.clear();
+    instances.clear();
+    netStates.clear();
+    pendingInputs.clear();
+    pendingGates.clear();
+    oscillatingGates.clear();
+    freeInputLabels.clear();
+    freeOutputLabels.clear();
     nextInputLabel = 0;
     nextOutputLabel = 0;
+    invalidateTopology();
 }
 
 void Circuit::drawAllGates(sf::RenderWindow& window) const {
@@ -74,19 +291,31 @@ void Circuit::drawAllGates(sf::RenderWindow& window) const {
     extern int g_selectedPin;
 
     try {
-        selectedGate = (g_selectedGate >= 0 && g_selectedGate < static_cast<int>(gates.size())) ? g_selectedGate : -1;
-        selectedPin = (selectedGate != -1 && g_selectedPin >= -1) ? g_selectedPin : -100;
+        selectedGate = (g_selectedGate >= 0 && gates.contains(static_cast<size_t>(g_selectedGate))) ? g_selectedGate : -1;
+        selectedPin = (selectedGate != -1 && g_selectedPin > -100) ? g_selectedPin : -100;
+
+        // Only gates inside the current view are drawn, so large circuits
+        // cost per frame what is on screen. The margin keeps pins visible.
+        const sf::View& view = window.getView();
+        const sf::Vector2f margin{20.f, 20.f};
+        const sf::FloatRect visible(view.getCenter() - view.getSize() / 2.f - margin, view.getSize() + 2.f * margin);
 
-        const size_t gateCount = gates.size();
-        for (size_t i = 0; i < gateCount; ++i) {
+        const size_t slotCount = gates.slotCount();
+        for (size_t i = 0; i < slotCount; ++i) {
             try {
-                if (i >= gates.size()) break;
+                if (!gates.contains(i)) continue;
 
                 const Gate& currentGate = gates[i];
+                if (!visible.findIntersection(currentGate.getBounds())) continue;
+                uint64_t outputStates = i < netStates.size() && netStates[i];
+                if (currentGate.getType() == GateType::MODULE) {
+                    outputStates = 0;
+                    for (int k = 0; k < currentGate.getOutputPinCount(); ++k) outputStates |= uint64_t{readState(i, -1 - k)} << k;
+                }
                 if ((int)i == selectedGate) {
-                    currentGate.draw(window, i, gates, selectedPin);
+                    currentGate.draw(window, outputStates, selectedPin);
                 } else {
-                    currentGate.draw(window, i, gates, -100);
+                    currentGate.draw(window, outputStates, -100);
                 }
             } catch (const std::exception&) {
                 continue;
@@ -97,313 +326,246 @@ void Circuit::drawAllGates(sf::RenderWindow& window) const {
     }
 }
 
-void Circuit::removeGate(size_t gateIndex) {
-    if (gateIndex < gates.size()) {
-        gates.erase(gates.begin() + gateIndex);
-
-        int inputLabel = 0, outputLabel = 0;
-        inputCounter = 0;
-        outputCounter = 0;
-
-        for (auto& gate : gates) {
-            if (gate.getType() == GateType::INPUT) {
-                gate.setPersistentLabel(inputLabel++);
-                ++inputCounter;
-            } else if (gate.getType() == GateType::OUTPUT) {
-                gate.setPersistentLabel(outputLabel++);
-                ++outputCounter;
-            }
-        }
-        nextInputLabel = inputLabel;
-        nextOutputLabel = outputLabel;
+void Circuit::removeGate(GateHandle handle) {
+    if (!gates.contains(handle)) return;
+    const size_t slot = handle.index;
+    const bool hadInstances = !instances.empty();
+
+    removeWiresConnectedToGate(slot);
+    instances.erase(slot);
+
+    // Other gates keep their slots and labels; the freed label is handed to
+    // the next gate of the same type.
+    const Gate& gate = gates[slot];
+    if (gate.getType() == GateType::INPUT && gate.getPersistentLabel() >= 0) freeInputLabels.insert(gate.getPersistentLabel());
+    if (gate.getType() == GateType::OUTPUT && gate.getPersistentLabel() >= 0) freeOutputLabels.insert(gate.getPersistentLabel());
+    gates.erase(handle);
+    netStates[slot] = 0;
+
+    markEdited();
+    if (hadInstances) {
+        compiled.invalidate();
+    } else if (compiled.isCompiled()) {
+        compiled.removeGate(slot, pendingGates);
+        pendingInputs.erase(std::remove(pendingInputs.begin(), pendingInputs.end(), slot), pendingInputs.end());
     }
 }
 
 void Circuit::removeWiresConnectedToGate(size_t gateIndex) {
-    if (gateIndex >= gates.size()) return;
-
-    wires.erase(
-        std::remove_if(wires.begin(), wires.end(), [gateIndex](const Wire& w) { return w.getSrcGate() == gateIndex || w.getDstGate() == gateIndex; }),
-        wires.end());
+    if (!gates.contains(gateIndex)) return;
 
-    for (auto& w : wires) {
-        if (w.getSrcGate() > gateIndex) w.setSrcGate(w.getSrcGate() - 1);
-        if (w.getDstGate() > gateIndex) w.setDstGate(w.getDstGate() - 1);
+    std::vector<uint32_t*> outputs{&drivenNet[gateIndex]};
+    if (auto it = instances.find(gateIndex); it != instances.end()) {
+        for (uint32_t& net : it->second.outputNets) outputs.push_back(&net);
     }
-}
-
-void Circuit::updateWirePositions() {
-    wires.erase(std::remove_if(wires.begin(), wires.end(),
-                               [this](const Wire& w) { return w.getSrcGate() >= gates.size() || w.getDstGate() >= gates.size(); }),
-                wires.end());
-
-    for (auto& wire : wires) {
-        try {
-            sf::Vector2f start, end;
-            const bool isFeedbackLoop = wire.getDstGate() <= wire.getSrcGate();
-
-            const Gate& srcGate = gates.at(wire.getSrcGate());
-            start = (wire.getSrcPin() == -1) ? srcGate.getOutputPinPosition() : srcGate.getInputPinPosition(wire.getSrcPin());
-
-            const Gate& dstGate = gates.at(wire.getDstGate());
-            end = (wire.getDstPin() == -1) ? dstGate.getOutputPinPosition() : dstGate.getInputPinPosition(wire.getDstPin());
-
-            if (isFeedbackLoop) {
-                const float vertOffset = 40.0f;
-                const float horizOffset = 30.0f;
-
-                sf::Vector2f p1 = start + sf::Vector2f(horizOffset, 0);
-                sf::Vector2f p2 = p1 + sf::Vector2f(0, -vertOffset);
-                sf::Vector2f p3 = end + sf::Vector2f(-horizOffset, -vertOffset);
-                sf::Vector2f p4 = end + sf::Vector2f(-horizOffset, 0);
-
-                wire.setPositions(start, end);
-            } else {
-                wire.setPositions(start, end);
-            }
-        } catch (const std::exception&) {
-            continue;
+    for (uint32_t* driven : outputs) {
+        if (*driven == NO_NET) continue;
+        for (const Net::Sink& sink : nets[*driven].getSinks()) {
+            std::vector<uint32_t>& sinkOf = sinkNets[sink.gate];
+            sinkOf.erase(std::find(sinkOf.begin(), sinkOf.end(), *driven));
         }
+        nets.erase(static_cast<size_t>(*driven));
+        *driven = NO_NET;
     }
-}
 
-void Circuit::evaluateCircuit() {
-    if (gates.empty()) return;
-
-    const int MAX_ITERATIONS = 100;
-    const size_t gateCount = gates.size();
-
-    std::vector<bool> newStates(gateCount, false);
-    std::vector<bool> oldStates(gateCount, false);
-    std::vector<bool> gateEvaluated(gateCount, false);
-
-    for (size_t i = 0; i < gateCount; ++i) {
-        oldStates[i] = gates[i].getState();
-        newStates[i] = oldStates[i];
-
-        if (gates[i].getType() == GateType::INPUT) {
-            gateEvaluated[i] = true;
+    for (uint32_t net : sinkNets[gateIndex]) {
+        if (!nets.contains(net)) continue;
+        Net& n = nets[net];
+        n.removeSinksOf(gateIndex);
+        if (n.empty()) {
+            drivenNetOf(n.getDriverGate(), n.getDriverPin()) = NO_NET;
+            nets.erase(static_cast<size_t>(net));
         }
     }
+    sinkNets[gateIndex].clear();
 
-    bool changed = true;
-    int iterations = 0;
-
-    while (changed && iterations < MAX_ITERATIONS) {
-        changed = false;
+    markEdited();
+    if (!instances.empty()) {
+        compiled.invalidate();
+    } else if (compiled.isCompiled()) {
+        compiled.disconnectGate(gateIndex, pendingGates);
+    }
+}
 
-        for (size_t i = 0; i < gateCount; ++i) {
-            if (gates[i].getType() != GateType::INPUT) {
-                gateEvaluated[i] = false;
-            }
+void Circuit::setGateInputCount(size_t gateIndex, int count) {
+    if (!gates.contains(gateIndex) || !isMultiInput(gates[gateIndex].getType())) return;
+
+    Gate& gate = gates[gateIndex];
+    if (gate.getInputPinCount() == count) return;
+    gate.setInputPinCount(count);
+    count = gate.getInputPinCount();
+
+    std::vector<uint32_t> touched = sinkNets[gateIndex];
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    bool rewired = false;
+    for (uint32_t net : touched) {
+        Net& n = nets[net];
+        if (n.removeSinksOf(gateIndex, count) > 0) rewired = true;
+        if (n.empty()) {
+            drivenNetOf(n.getDriverGate(), n.getDriverPin()) = NO_NET;
+            nets.erase(static_cast<size_t>(net));
+            continue;
         }
-
-        for (size_t i = 0; i < gateCount; ++i) {
-            if (gateEvaluated[i]) continue;
-
-            if (gates[i].getType() == GateType::OUTPUT) {
-                std::vector<bool> inputs;
-                for (const auto& w : wires) {
-                    if (w.getDstGate() == i && w.getSrcGate() < gateCount && gateEvaluated[w.getSrcGate()]) {
-                        inputs.push_back(oldStates[w.getSrcGate()]);
-                    }
-                }
-                newStates[i] = inputs.empty() ? false : inputs[0];
-                gateEvaluated[i] = true;
-                if (newStates[i] != oldStates[i]) changed = true;
-                continue;
-            }
-
-            std::vector<bool> inputs;
-            bool allInputsEvaluated = true;
-
-            for (const auto& w : wires) {
-                if (w.getDstGate() == i && w.getSrcGate() < gateCount) {
-                    if (!gateEvaluated[w.getSrcGate()]) {
-                        allInputsEvaluated = false;
-                        break;
-                    }
-                    inputs.push_back(oldStates[w.getSrcGate()]);
-                }
-            }
-
-            if (allInputsEvaluated) {
-                newStates[i] = inputs.empty() ? false : gates[i].evaluate(inputs);
-                gateEvaluated[i] = true;
-                if (newStates[i] != oldStates[i]) changed = true;
+        n.moveSinksOf(gateIndex, [&gate](int pin) { return gate.getInputPinPosition(pin); });
+    }
+    if (rewired) {
+        std::vector<uint32_t>& sinkOf = sinkNets[gateIndex];
+        sinkOf.clear();
+        for (uint32_t net : touched) {
+            if (!nets.contains(net)) continue;
+            for (const Net::Sink& sink : nets[net].getSinks()) {
+                if (sink.gate == gateIndex) sinkOf.push_back(net);
             }
         }
-
-        oldStates = newStates;
-        iterations++;
     }
 
-    for (size_t i = 0; i < gates.size(); ++i) {
-        gates[i].setState(newStates[i]);
+    if (drivenNet[gateIndex] != NO_NET) {
+        Net& driven = nets[drivenNet[gateIndex]];
+        driven.setDriverPosition(driven.getDriverPin() == -1 ? gate.getOutputPinPosition() : gate.getInputPinPosition(driven.getDriverPin()));
     }
-}
-std::vector<size_t> Circuit::getInputGates() const {
-    std::vector<size_t> inputs;
-    for (size_t i = 0; i < gates.size(); ++i) {
-        if (gates[i].getType() == GateType::INPUT) inputs.push_back(i);
-    }
-    return inputs;
-}
 
-std::vector<size_t> Circuit::getOutputGates() const {
-    std::vector<size_t> outputs;
-    if (gates.empty()) return outputs;
-
-    for (size_t i = 0; i < gates.size(); ++i) {
-        if (gates[i].getType() == GateType::OUTPUT) {
-            outputs.push_back(i);
-        }
-    }
-    return outputs;
+    // Only removed wires change the logic; the compiled circuit has no
+    // single-wire removal, so recompile in that case.
+    if (rewired) invalidateTopology();
 }
 
-std::string Circuit::generateExpressionForGate(size_t gateIndex, std::map<size_t, std::string>& expressions) const {
-    if (gateIndex >= gates.size()) return "0";
-    if (auto it = expressions.find(gateIndex); it != expressions.end()) {
-        return it->second;
-    }
-
-    const Gate& gate = gates[gateIndex];
-    std::string result;
+void Circuit::evaluateCircuit() {
+    if (gates.empty()) return;
 
-    if (gate.getType() == GateType::INPUT) {
-        result = (gate.getPersistentLabel() >= 0) ? std::string(1, static_cast<char>('A' + gate.getPersistentLabel())) : "0";
-        expressions[gateIndex] = result;
-        return result;
+    if (!compiled.isCompiled()) compile();
+
+    if (!compiled.isAcyclic()) {
+        netStatesValid = false;
+        if (loopsSettled && pendingInputs.empty() && pendingGates.empty()) return;
+        pendingInputs.clear();
+        pendingGates.clear();
+
+        compiled.refresh();
+        settleLoops();
+        std::vector<size_t> clocked;
+        compiled.updateRegisters(netStates, clocked);
+        if (!clocked.empty()) settleLoops();
+        loopsSettled = true;
+        updateNetStates();
+        return;
     }
-
-    std::vector<std::string> inputExprs;
-    std::vector<size_t> inputGates;
-
-    for (const Wire& wire : wires) {
-        if (wire.getDstGate() != gateIndex || wire.getSrcGate() >= gates.size()) continue;
-
-        if (wire.getSrcGate() == gateIndex) continue;
-
-        inputGates.push_back(wire.getSrcGate());
-
-        std::string inExpr = generateExpressionForGate(wire.getSrcGate(), expressions);
-        if (inExpr != "0") {
-            inputExprs.push_back(inExpr);
-        }
+    // The last loop was just broken; clear its markers.
+    if (!oscillatingGates.empty()) settleLoops();
+
+    if (evaluationMode == EvaluationMode::EventDriven && netStatesValid) {
+        if (pendingInputs.empty() && pendingGates.empty()) return;
+
+        std::vector<size_t> changed;
+        compiled.propagate(netStates, pendingInputs, changed);
+        compiled.reevaluate(netStates, pendingGates, changed);
+        changed.insert(changed.end(), pendingInputs.begin(), pendingInputs.end());
+        pendingInputs.clear();
+        pendingGates.clear();
+        clockRegisters(changed);
+        updateNetStates(changed);
+        return;
     }
 
-    std::sort(inputExprs.begin(), inputExprs.end());
-
-    if (inputExprs.empty()) {
-        result = "0";
-    } else if (gate.getType() == GateType::OUTPUT) {
-        result = inputExprs[0];
-    } else {
-        bool validInputs = (gate.getType() == GateType::NOT && inputExprs.size() == 1) || (gate.getType() != GateType::NOT && inputExprs.size() == 2);
-
-        if (!validInputs) {
-            result = "0";
-        } else {
-            switch (gate.getType()) {
-                case GateType::AND:
-                    result = "(" + inputExprs[0] + "." + inputExprs[1] + ")";
-                    break;
-                case GateType::OR:
-                    result = "(" + inputExprs[0] + "+" + inputExprs[1] + ")";
-                    break;
-                case GateType::NOT:
-                    result = "~(" + inputExprs[0] + ")";
-                    break;
-                case GateType::NAND:
-                    result = "~(" + inputExprs[0] + "." + inputExprs[1] + ")";
-                    break;
-                case GateType::NOR:
-                    result = "~(" + inputExprs[0] + "+" + inputExprs[1] + ")";
-                    break;
-                case GateType::XOR:
-                    result = "(" + inputExprs[0] + "^" + inputExprs[1] + ")";
-                    break;
-                default:
-                    result = "0";
-            }
-        }
-    }
+    compiled.refresh();
+    compiled.evaluate(netStates);
+    pendingInputs.clear();
+    pendingGates.clear();
+    netStatesValid = true;
 
-    expressions[gateIndex] = result;
-    return result;
+    std::vector<size_t> changed;
+    clockRegisters(changed);
+    updateNetStates();
 }
 
-std::string Circuit::getGateSymbol(GateType type) const {
-    switch (type) {
-        case GateType::AND:
-            return ".";
-        case GateType::OR:
-            return "+";
-        case GateType::NOT:
-            return "~";
-        case GateType::NAND:
-            return "NAND";
-        case GateType::NOR:
-            return "NOR";
-        case GateType::XOR:
-            return "^";
-        default:
-            return "";
+void Circuit::settleLoops() {
+    for (size_t gate : oscillatingGates) {
+        if (gates.contains(gate)) gates[gate].setOscillating(false);
+    }
+    for (const auto& instance : instances) gates[instance.first].setOscillating(false);
+    oscillatingGates.clear();
+    if (!compiled.isAcyclic()) compiled.settle(netStates, &oscillatingGates);
+    // A loop inside a module body marks the instance.
+    for (size_t gate : oscillatingGates) {
+        const size_t owner = ownerOf(gate);
+        if (owner != SIZE_MAX) gates[owner].setOscillating(true);
     }
 }
 
-std::string Circuit::getExactEquation() const {
-    if (gates.empty()) {
-        return "";
+void Circuit::updateNetStates() {
+    for (size_t slot = 0; slot < nets.slotCount(); ++slot) {
+        if (nets.contains(slot)) nets[slot].setState(readState(nets[slot].getDriverGate(), nets[slot].getDriverPin()));
     }
+}
 
-    std::vector<size_t> outputGates = getOutputGates();
-    if (outputGates.empty()) {
-        return "";
+// One lookup per changed driver, however many sinks its net has.
+void Circuit::updateNetStates(const std::vector<size_t>& changed) {
+    for (size_t gate : changed) {
+        if (gate < drivenNet.size() && drivenNet[gate] != NO_NET) nets[drivenNet[gate]].setState(netStates[gate]);
     }
-
-    std::vector<std::string> outputExpressions;
-    for (size_t outputIndex : outputGates) {
-        std::map<size_t, std::string> expressions;
-        std::string expr = generateExpressionForGate(outputIndex, expressions);
-        if (!expr.empty() && expr != "0") {
-            outputExpressions.push_back(expr);
+    // Module outputs read body slots, which have no net of their own.
+    for (const auto& [gate, instance] : instances) {
+        for (size_t k = 0; k < instance.outputNets.size(); ++k) {
+            if (instance.outputNets[k] != NO_NET) nets[instance.outputNets[k]].setState(readState(gate, -1 - static_cast<int>(k)));
         }
     }
+}
 
-    if (outputExpressions.empty()) {
-        return "0";
-    }
+void Circuit::clockRegisters(std::vector<size_t>& changed) {
+    if (compiled.getRegisters().empty()) return;
 
-    if (outputExpressions.size() == 1) {
-        return outputExpressions[0];
+    // A register update can produce another clock edge downstream, so keep
+    // going until the flip-flops are stable.
+    std::vector<size_t> clocked;
+    for (int pass = 0; pass < CompiledCircuit::MAX_ITERATIONS; ++pass) {
+        clocked.clear();
+        compiled.updateRegisters(netStates, clocked);
+        if (clocked.empty()) break;
+
+        changed.insert(changed.end(), clocked.begin(), clocked.end());
+        compiled.propagate(netStates, clocked, changed);
     }
+}
 
-    return outputExpressions[0];
+std::vector<std::vector<uint64_t>> Circuit::generateOutputTruthTable() {
+    if (!compiled.isCompiled()) compile();
+    compiled.refresh();
+    return compiled.generateTruthTable();
 }
 
-std::vector<std::string> Circuit::getAllOutputEquations() const {
-    std::vector<std::string> outputExpressions;
+void Circuit::setInputState(size_t gateIndex, bool state) {
+    if (!gates.contains(gateIndex)) return;
+    if (gates[gateIndex].getType() != GateType::INPUT && gates[gateIndex].getType() != GateType::CLOCK) return;
 
-    if (gates.empty()) {
-        return outputExpressions;
-    }
+    netStates[gateIndex] = state;
+    pendingInputs.push_back(gateIndex);
+}
 
-    std::vector<size_t> outputGates = getOutputGates();
-    if (outputGates.empty()) {
-        return outputExpressions;
+std::vector<size_t> Circuit::getInputGates() const {
+    std::vector<size_t> inputs;
+    for (size_t slot = 0; slot < gates.slotCount(); ++slot) {
+        if (gates.contains(slot) && gates[slot].getType() == GateType::INPUT) inputs.push_back(slot);
     }
+    return inputs;
+}
 
-    for (size_t outputIndex : outputGates) {
-        std::map<size_t, std::string> expressions;
-        std::string expr = generateExpressionForGate(outputIndex, expressions);
-        if (!expr.empty() && expr != "0") {
-            outputExpressions.push_back(expr);
-        } else {
-            outputExpressions.push_back("0");
-        }
+std::vector<size_t> Circuit::getOutputGates() const {
+    std::vector<size_t> outputs;
+    for (size_t slot = 0; slot < gates.slotCount(); ++slot) {
+        if (gates.contains(slot) && gates[slot].getType() == GateType::OUTPUT) outputs.push_back(slot);
     }
+    return outputs;
+}
+
+std::string Circuit::generateExpressionForGate(size_t gateIndex, std::map<size_t, std::string>& expressions) const {
+    const Netlist& current = getNetlist();
+    if (!gates.contains(gateIndex)) return "0";
+    return current.generateExpressionForGate(netlistIndex[gateIndex], expressions);
+}
+
+std::string Circuit::getGateSymbol(GateType type) const { return getNetlist().getGateSymbol(type); }
+
+std::string Circuit::getExactEquation() const { return getNetlist().getExactEquation(); }
 
-    return outputExpressions;
-}
\ No newline at end of file
+std::vector<std::string> Circuit::getAllOutputEquations() const { return getNetlist().getAllOutputEquations(); }
@@ -1,43 +1,137 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "CompiledCircuit.hpp"
 #include "Gate.hpp"
-#include "Wire.hpp"
+#include "ModuleLibrary.hpp"
+#include "Net.hpp"
+#include "Netlist.hpp"
+#include "SlotMap.hpp"
+
+enum class EvaluationMode { Levelized, EventDriven };
+
+using GateHandle = SlotHandle;
 
 class Circuit {
    private:
-    std::vector<Gate> gates;
-    std::vector<Wire> wires;
-    int inputCounter = 0;
-    int outputCounter = 0;
+    // Gates and nets never move once added, so a gate's slot is its index
+    // everywhere (nets, netStates, the compiled circuit) until it is removed.
+    SlotMap<Gate> gates;
+    SlotMap<Net> nets;
+    // Per gate slot: the net its output drives (NO_NET if unconnected) and
+    // the nets it is a sink of, so removing a gate touches only its own nets.
+    std::vector<uint32_t> drivenNet;
+    std::vector<std::vector<uint32_t>> sinkNets;
+    static constexpr uint32_t NO_NET = UINT32_MAX;
+    // A placed module is one MODULE gate; its nets are kept per output pin.
+    // Its body is flattened on compile into the slots past the editor's, so
+    // state holds the instance's slice of netStates and the slots its outputs
+    // read from.
+    struct ModuleInstance {
+        size_t definition;
+        std::vector<uint32_t> outputNets;
+        mutable InstanceRange state;
+    };
+    ModuleLibrary modules;
+    std::unordered_map<size_t, ModuleInstance> instances;
     int nextInputLabel = 0;
     int nextOutputLabel = 0;
+    std::set<int> freeInputLabels;
+    std::set<int> freeOutputLabels;
     const sf::Font* currentFont = nullptr;
+    mutable Netlist netlist;
+    mutable Netlist editorNetlist;
+    // Slot of each netlist gate and netlist index of each slot (SIZE_MAX for
+    // holes and modules); the netlist itself is dense and flat.
+    mutable std::vector<size_t> netlistSlots;
+    mutable std::vector<size_t> netlistIndex;
+    mutable size_t stateSlotCount = 0;
+    mutable bool netlistDirty = true;
+    size_t revision = 0;
+    CompiledCircuit compiled;
+    EvaluationMode evaluationMode = EvaluationMode::EventDriven;
+    // Logic value of every gate slot; Gate holds render data only.
+    std::vector<uint8_t> netStates;
+    std::vector<size_t> pendingInputs;
+    std::vector<size_t> pendingGates;
+    bool netStatesValid = false;
+    // Cyclic circuits are only settled again after an edit or input change.
+    bool loopsSettled = false;
+    std::vector<size_t> oscillatingGates;
 
-    bool hasCycle(size_t startGate, std::vector<bool>& visited, std::vector<bool>& inStack) const;
+    void markEdited();
+    void invalidateTopology();
+    void compile();
+    static int takeLabel(std::set<int>& freeLabels, int& nextLabel);
+    void clockRegisters(std::vector<size_t>& changed);
+    void updateNetStates();
+    void updateNetStates(const std::vector<size_t>& changed);
+    void settleLoops();
+    void growSlots(size_t slot);
+    // Output pin -1 - k of a module is its k-th output; every other gate has
+    // the single output pin -1.
+    uint32_t& drivenNetOf(size_t gate, int pin);
+    size_t stateSlotOf(size_t gate, int pin) const;
+    bool readState(size_t gate, int pin) const;
+    // The editor gate a compiled slot belongs to, SIZE_MAX if none.
+    size_t ownerOf(size_t slot) const;
 
    public:
     void setFont(const sf::Font& font);
-    void addGate(GateType type, sf::Vector2f position);
+    // New INPUT/OUTPUT gates take the lowest label freed by a removal, if any.
+    GateHandle addGate(GateType type, sf::Vector2f position);
+    // Places an instance of a definition in getModuleLibrary().
+    GateHandle addModule(size_t definition, sf::Vector2f position);
+    // Adds the gates as a new definition: their INPUT and OUTPUT gates become
+    // its pins in slot order and wires between them are kept. Returns its
+    // id, or -1 if the name is taken or the gates have no OUTPUT.
+    int defineModule(const std::string& name, const std::vector<GateHandle>& members);
+    const ModuleLibrary& getModuleLibrary() const { return modules; }
     void addWire(size_t srcGate, int srcPin, size_t dstGate, int dstPin);
     void clearCircuit();
     void deselectAllGates();
     void drawAllGates(sf::RenderWindow& window) const;
-    void removeGate(size_t gateIndex);
+    // Removes the gate and its wires; no other gate changes slot or label.
+    void removeGate(GateHandle handle);
+    void removeGate(size_t gateIndex) { removeGate(gates.handleAt(gateIndex)); }
     void removeWiresConnectedToGate(size_t gateIndex);
-    void updateWirePositions();
+    // Resizes an AND/OR/NAND/NOR/XOR gate; wires on pins that no longer
+    // exist are removed.
+    void setGateInputCount(size_t gateIndex, int count);
     void evaluateCircuit();
+    void setInputState(size_t gateIndex, bool state);
+    bool getState(size_t gateIndex) const { return gateIndex < netStates.size() && netStates[gateIndex]; }
+    // Gates on combinational loops that failed to settle in the last evaluation.
+    const std::vector<size_t>& getOscillatingGates() const { return oscillatingGates; }
+    void setEvaluationMode(EvaluationMode mode) { evaluationMode = mode; }
+    EvaluationMode getEvaluationMode() const { return evaluationMode; }
+    // Exhaustive truth table of a combinational circuit, one packed bitset
+    // per gate of getOutputGates(); row bits follow getInputGates(), first
+    // input most significant. Empty if the circuit has loops or registers.
+    std::vector<std::vector<uint64_t>> generateOutputTruthTable();
     std::vector<size_t> getInputGates() const;
     std::vector<size_t> getOutputGates() const;
+    // Expression driving the gate in slot gateIndex; expressions memoizes
+    // subexpressions by netlist index across calls.
     std::string generateExpressionForGate(size_t gateIndex, std::map<size_t, std::string>& expressions) const;
     std::string getGateSymbol(GateType type) const;
     std::string getExactEquation() const;
     std::vector<std::string> getAllOutputEquations() const;
-    const std::vector<Gate>& getGates() const { return gates; }
-    std::vector<Gate>& getGates() { return gates; }
-    const std::vector<Wire>& getWires() const { return wires; }
-    std::vector<Wire>& getWires() { return wires; }
+    const Netlist& getNetlist() const;
+    // Bumped on every edit, so views can skip rebuilding derived data.
+    size_t getRevision() const { return revision; }
+    // Gates live in slots [0, getSlotCount()); removed ones leave holes.
+    size_t getSlotCount() const { return gates.slotCount(); }
+    size_t getGateCount() const { return gates.size(); }
+    bool hasGate(size_t gateIndex) const { return gates.contains(gateIndex); }
+    bool isValid(GateHandle handle) const { return gates.contains(handle); }
+    GateHandle getGateHandle(size_t gateIndex) const { return gates.handleAt(gateIndex); }
+    const Gate& getGate(size_t gateIndex) const { return gates[gateIndex]; }
+    Gate& getGate(size_t gateIndex) { return gates[gateIndex]; }
+    const SlotMap<Net>& getNets() const { return nets; }
 };
\ No newline at end of file
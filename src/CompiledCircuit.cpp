@@ -0,0 +1,727 @@
+#include "CompiledCircuit.hpp"
+
+#include <algorithm>
+#include <bitset>
+
+void CompiledCircuit::compile(const Netlist& netlist) { compile(netlist, {}, netlist.getGateCount()); }
+
+void CompiledCircuit::compile(const Netlist& netlist, const std::vector<size_t>& slots, size_t slotCount) {
+    const size_t gateCount = netlist.getGateCount();
+    if (!slots.empty() && slots.size() != gateCount) return;
+    auto slotOf = [&slots](size_t gate) { return slots.empty() ? gate : slots[gate]; };
+
+    types.assign(slotCount, GateType::INPUT);
+    vacant.assign(slotCount, 1);
+    for (size_t gate = 0; gate < gateCount; ++gate) {
+        types[slotOf(gate)] = netlist.getType(gate);
+        vacant[slotOf(gate)] = 0;
+    }
+
+    inputGates.clear();
+    outputGates.clear();
+    registers.clear();
+    latchCount = 0;
+    sequentialCount = 0;
+    for (size_t i = 0; i < slotCount; ++i) {
+        if (vacant[i]) continue;
+        if (types[i] == GateType::INPUT) inputGates.push_back(i);
+        if (types[i] == GateType::OUTPUT) outputGates.push_back(i);
+        if (types[i] == GateType::DFF) registers.push_back(i);
+        countGate(types[i], 1);
+    }
+
+    // Drivers are kept in connection order so "first input" keeps the
+    // meaning it has in Gate::evaluate.
+    fanIn.assign(slotCount, {});
+    fanInPins.assign(slotCount, {});
+    fanOut.assign(slotCount, {});
+    for (const auto& c : netlist.getConnections()) {
+        if (c.srcGate >= gateCount || c.dstGate >= gateCount) continue;
+        const size_t src = slotOf(c.srcGate);
+        const size_t dst = slotOf(c.dstGate);
+        if (!hasFanIn(types[dst])) continue;
+        fanIn[dst].push_back(src);
+        fanInPins[dst].push_back(c.dstPin);
+        fanOut[src].push_back(dst);
+    }
+
+    queued.assign(slotCount, 0);
+    lastClock.clear();
+    levelize();
+    compiled = true;
+}
+
+void CompiledCircuit::countGate(GateType type, int delta) {
+    if (type == GateType::LATCH) latchCount += delta;
+    if (type == GateType::DFF || type == GateType::LATCH || type == GateType::CLOCK) sequentialCount += delta;
+}
+
+void CompiledCircuit::levelize() {
+    const size_t gateCount = types.size();
+
+    // Kahn's algorithm. Anything left unordered sits on a feedback loop.
+    // Register outputs start at level 0, which breaks loops through a DFF.
+    std::vector<size_t> pending(gateCount);
+    order.clear();
+    order.reserve(gateCount);
+    levels.assign(gateCount, 0);
+    for (size_t i = 0; i < gateCount; ++i) {
+        pending[i] = isSource(types[i]) ? 0 : fanIn[i].size();
+        if (pending[i] == 0) order.push_back(i);
+    }
+
+    for (size_t head = 0; head < order.size(); ++head) {
+        size_t src = order[head];
+        for (size_t dst : fanOut[src]) {
+            if (isSource(types[dst])) continue;
+            if (levels[dst] < levels[src] + 1) levels[dst] = levels[src] + 1;
+            if (--pending[dst] == 0) order.push_back(dst);
+        }
+    }
+
+    acyclic = order.size() == gateCount;
+    findComponents();
+    maxLevel = 0;
+    for (int level : levels) {
+        if (level > maxLevel) maxLevel = level;
+    }
+    levelQueues.assign(maxLevel + 1, {});
+
+    buildProgram();
+}
+
+void CompiledCircuit::findComponents() {
+    componentOffsets.clear();
+    componentGates.clear();
+    feedback.clear();
+    if (acyclic) return;
+
+    // Tarjan's algorithm with an explicit call stack. Edges into sources are
+    // not combinational, so a loop through a DFF is not a component.
+    const size_t gateCount = types.size();
+    std::vector<size_t> index(gateCount, SIZE_MAX);
+    std::vector<size_t> low(gateCount, 0);
+    std::vector<uint8_t> onStack(gateCount, 0);
+    std::vector<size_t> stack;
+    std::vector<std::pair<size_t, size_t>> calls;
+    std::vector<size_t> found;
+    std::vector<size_t> foundOffsets{0};
+    size_t counter = 0;
+
+    auto visit = [&](size_t gate) {
+        index[gate] = low[gate] = counter++;
+        stack.push_back(gate);
+        onStack[gate] = 1;
+        calls.push_back({gate, 0});
+    };
+
+    for (size_t root = 0; root < gateCount; ++root) {
+        if (index[root] != SIZE_MAX) continue;
+        visit(root);
+        while (!calls.empty()) {
+            const size_t gate = calls.back().first;
+            const size_t next = calls.back().second++;
+            if (next < fanOut[gate].size()) {
+                const size_t dst = fanOut[gate][next];
+                if (isSource(types[dst])) continue;
+                if (index[dst] == SIZE_MAX) {
+                    visit(dst);
+                } else if (onStack[dst]) {
+                    low[gate] = std::min(low[gate], index[dst]);
+                }
+                continue;
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) low[calls.back().first] = std::min(low[calls.back().first], low[gate]);
+            if (low[gate] != index[gate]) continue;
+
+            size_t member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = 0;
+                found.push_back(member);
+            } while (member != gate);
+            foundOffsets.push_back(found.size());
+        }
+    }
+
+    // Tarjan emits components sinks first; store them in topological order.
+    const size_t componentCount = foundOffsets.size() - 1;
+    componentOffsets.reserve(componentCount + 1);
+    componentGates.reserve(found.size());
+    componentOffsets.push_back(0);
+    for (size_t c = componentCount; c-- > 0;) {
+        const size_t first = foundOffsets[c];
+        const size_t last = foundOffsets[c + 1];
+        componentGates.insert(componentGates.end(), found.begin() + first, found.begin() + last);
+        componentOffsets.push_back(componentGates.size());
+
+        const size_t gate = found[first];
+        const bool selfLoop = !isSource(types[gate]) && std::find(fanIn[gate].begin(), fanIn[gate].end(), gate) != fanIn[gate].end();
+        feedback.push_back(last - first > 1 || selfLoop);
+    }
+}
+
+void CompiledCircuit::flattenAdjacency() {
+    auto flatten = [](const std::vector<std::vector<size_t>>& lists, std::vector<size_t>& offsets, std::vector<size_t>& flat) {
+        offsets.resize(lists.size() + 1);
+        flat.clear();
+        for (size_t gate = 0; gate < lists.size(); ++gate) {
+            offsets[gate] = flat.size();
+            flat.insert(flat.end(), lists[gate].begin(), lists[gate].end());
+        }
+        offsets[lists.size()] = flat.size();
+    };
+    flatten(fanIn, fanInOffsets, fanInList);
+    flatten(fanOut, fanOutOffsets, fanOutList);
+}
+
+void CompiledCircuit::buildProgram() {
+    flattenAdjacency();
+    program.clear();
+    if (acyclic && latchCount == 0) {
+        program.reserve(types.size());
+        for (size_t gate : order) {
+            if (isSource(types[gate])) continue;
+
+            const std::vector<size_t>& drivers = fanIn[gate];
+            appendWordOps(types[gate], drivers.data(), drivers.size(), static_cast<uint32_t>(gate), program);
+        }
+    }
+
+    if (program.empty()) {
+        bytecode.clear();
+    } else {
+        bytecode.assemble(program);
+    }
+    stale = false;
+}
+
+void CompiledCircuit::refresh() {
+    if (!compiled || !stale) return;
+    if (!acyclic) {
+        levelize();
+        return;
+    }
+
+    // Levels are kept valid by every edit, so a counting sort on them is a
+    // topological order; no graph traversal is needed.
+    std::vector<size_t> start(maxLevel + 2, 0);
+    for (int level : levels) ++start[level + 1];
+    for (int level = 0; level <= maxLevel; ++level) start[level + 1] += start[level];
+    order.assign(types.size(), 0);
+    for (size_t gate = 0; gate < types.size(); ++gate) order[start[levels[gate]]++] = gate;
+
+    buildProgram();
+}
+
+void CompiledCircuit::growLevels(int level) {
+    if (level <= maxLevel) return;
+    maxLevel = level;
+    levelQueues.resize(maxLevel + 1);
+}
+
+size_t CompiledCircuit::addGate(GateType type, size_t slot) {
+    if (slot == SIZE_MAX) slot = types.size();
+    if (slot < types.size() && !vacant[slot]) return SIZE_MAX;
+    if (slot >= types.size()) {
+        types.resize(slot + 1, GateType::INPUT);
+        vacant.resize(slot + 1, 1);
+        levels.resize(slot + 1, 0);
+        fanIn.resize(slot + 1);
+        fanInPins.resize(slot + 1);
+        fanOut.resize(slot + 1);
+        queued.resize(slot + 1, 0);
+    }
+    types[slot] = type;
+    vacant[slot] = 0;
+    levels[slot] = 0;
+
+    // The lists stay sorted by slot, which keeps inputs in declaration order.
+    auto insertSorted = [slot](std::vector<size_t>& list) { list.insert(std::upper_bound(list.begin(), list.end(), slot), slot); };
+    if (type == GateType::INPUT) insertSorted(inputGates);
+    if (type == GateType::OUTPUT) insertSorted(outputGates);
+    if (type == GateType::DFF) insertSorted(registers);
+    countGate(type, 1);
+    stale = true;
+    return slot;
+}
+
+void CompiledCircuit::addConnection(size_t srcGate, size_t dstGate, int dstPin) {
+    if (!compiled || srcGate >= types.size() || dstGate >= types.size() || !hasFanIn(types[dstGate])) return;
+
+    fanIn[dstGate].push_back(srcGate);
+    fanInPins[dstGate].push_back(dstPin);
+    fanOut[srcGate].push_back(dstGate);
+    stale = true;
+
+    if (!acyclic) {
+        levelize();
+        return;
+    }
+    if (isSource(types[dstGate]) || levels[dstGate] > levels[srcGate]) return;
+
+    // Push the new edge's cone upwards. A cycle must run through the new
+    // edge, so the wave reaches srcGate exactly when one was closed.
+    relevelQueue.clear();
+    relevelQueue.push_back(dstGate);
+    levels[dstGate] = levels[srcGate] + 1;
+    for (size_t head = 0; head < relevelQueue.size(); ++head) {
+        const size_t gate = relevelQueue[head];
+        if (gate == srcGate) {
+            levelize();
+            return;
+        }
+        growLevels(levels[gate]);
+        for (size_t dst : fanOut[gate]) {
+            if (isSource(types[dst]) || levels[dst] > levels[gate]) continue;
+            levels[dst] = levels[gate] + 1;
+            relevelQueue.push_back(dst);
+        }
+    }
+}
+
+void CompiledCircuit::disconnectGate(size_t gate, std::vector<size_t>& affected) {
+    if (!compiled || gate >= types.size()) return;
+
+    const size_t firstAffected = affected.size();
+    if (!fanIn[gate].empty()) affected.push_back(gate);
+    for (size_t src : fanIn[gate]) {
+        std::vector<size_t>& targets = fanOut[src];
+        targets.erase(std::remove(targets.begin(), targets.end(), gate), targets.end());
+    }
+    fanIn[gate].clear();
+    fanInPins[gate].clear();
+
+    for (size_t dst : fanOut[gate]) {
+        if (std::find(affected.begin() + firstAffected, affected.end(), dst) != affected.end()) continue;
+        affected.push_back(dst);
+
+        std::vector<size_t>& drivers = fanIn[dst];
+        std::vector<int>& pins = fanInPins[dst];
+        size_t kept = 0;
+        for (size_t k = 0; k < drivers.size(); ++k) {
+            if (drivers[k] == gate) continue;
+            drivers[kept] = drivers[k];
+            pins[kept++] = pins[k];
+        }
+        drivers.resize(kept);
+        pins.resize(kept);
+    }
+    fanOut[gate].clear();
+    stale = true;
+
+    if (!acyclic) {
+        levelize();
+        return;
+    }
+
+    // Levels only drop here; re-derive them for the former fan-out cone.
+    relevelQueue.assign(affected.begin() + firstAffected, affected.end());
+    for (size_t head = 0; head < relevelQueue.size(); ++head) {
+        const size_t current = relevelQueue[head];
+        if (isSource(types[current])) continue;
+
+        int level = 0;
+        for (size_t src : fanIn[current]) level = std::max(level, levels[src] + 1);
+        if (level >= levels[current]) continue;
+
+        levels[current] = level;
+        for (size_t dst : fanOut[current]) relevelQueue.push_back(dst);
+    }
+}
+
+void CompiledCircuit::removeGate(size_t gate, std::vector<size_t>& affected) {
+    if (!compiled || gate >= types.size() || vacant[gate]) return;
+
+    disconnectGate(gate, affected);
+
+    // Nothing is renumbered: the slot becomes an unwired source that no list
+    // refers to, so the cost is the gate's degree plus the I/O lists.
+    auto drop = [gate](std::vector<size_t>& indices) { indices.erase(std::remove(indices.begin(), indices.end(), gate), indices.end()); };
+    if (types[gate] == GateType::INPUT) drop(inputGates);
+    if (types[gate] == GateType::OUTPUT) drop(outputGates);
+    if (types[gate] == GateType::DFF) {
+        drop(registers);
+        lastClock.clear();
+    }
+    drop(affected);
+
+    countGate(types[gate], -1);
+    types[gate] = GateType::INPUT;
+    vacant[gate] = 1;
+    levels[gate] = 0;
+    stale = true;
+}
+
+bool CompiledCircuit::evaluateGate(GateType type, size_t inputCount, uint64_t inputs) {
+    const size_t width = std::min<size_t>(inputCount, MAX_GATE_INPUTS);
+    const uint64_t mask = width >= 64 ? ~0ULL : (1ULL << width) - 1;
+    inputs &= mask;
+    switch (type) {
+        case GateType::AND:
+            return width >= 2 && inputs == mask;
+        case GateType::OR:
+            return width >= 2 && inputs != 0;
+        case GateType::NOT:
+            return width >= 1 && !(inputs & 1);
+        case GateType::NAND:
+            return width >= 1 && !(width >= 2 && inputs == mask);
+        case GateType::NOR:
+            return width >= 1 && !(width >= 2 && inputs != 0);
+        case GateType::XOR:
+            return width >= 2 && (std::bitset<64>(inputs).count() & 1);
+        case GateType::OUTPUT:
+            return width >= 1 && (inputs & 1);
+        default:
+            return false;
+    }
+}
+
+uint64_t CompiledCircuit::packInputs(GateSpan drivers, const std::vector<uint8_t>& states) const {
+    const size_t width = std::min<size_t>(drivers.count, MAX_GATE_INPUTS);
+    uint64_t inputs = 0;
+    for (size_t k = 0; k < width; ++k) inputs |= static_cast<uint64_t>(states[drivers.gates[k]] & 1) << k;
+    return inputs;
+}
+
+size_t CompiledCircuit::getPinSource(size_t gate, int pin) const {
+    for (size_t k = 0; k < fanIn[gate].size(); ++k) {
+        if (fanInPins[gate][k] == pin) return fanIn[gate][k];
+    }
+    return SIZE_MAX;
+}
+
+bool CompiledCircuit::evaluateAt(size_t gate, const std::vector<uint8_t>& states) const {
+    if (types[gate] == GateType::DFF) return states[gate];
+    if (types[gate] == GateType::LATCH) {
+        const size_t d = getPinSource(gate, 0);
+        const size_t en = getPinSource(gate, 1);
+        if (en == SIZE_MAX || !states[en]) return states[gate];
+        return d != SIZE_MAX && states[d];
+    }
+
+    const GateSpan drivers = getDrivers(gate);
+    return evaluateGate(types[gate], drivers.count, packInputs(drivers, states));
+}
+
+uint64_t CompiledCircuit::evaluateGateWord(GateType type, size_t inputCount, uint64_t a, uint64_t b) {
+    switch (type) {
+        case GateType::AND:
+            return inputCount >= 2 ? (a & b) : 0;
+        case GateType::OR:
+            return inputCount >= 2 ? (a | b) : 0;
+        case GateType::NOT:
+            return inputCount >= 1 ? ~a : 0;
+        case GateType::NAND:
+            return inputCount >= 2 ? ~(a & b) : (inputCount == 1 ? ~0ULL : 0);
+        case GateType::NOR:
+            return inputCount >= 2 ? ~(a | b) : (inputCount == 1 ? ~0ULL : 0);
+        case GateType::XOR:
+            return inputCount >= 2 ? (a ^ b) : 0;
+        case GateType::OUTPUT:
+            return inputCount >= 1 ? a : 0;
+        default:
+            return 0;
+    }
+}
+
+WordOp CompiledCircuit::makeWordOp(GateType type, size_t inputCount, uint32_t dst, uint32_t a, uint32_t b) {
+    WordOpCode code = WordOpCode::ZERO;
+    switch (type) {
+        case GateType::AND:
+            if (inputCount >= 2) code = WordOpCode::AND;
+            break;
+        case GateType::OR:
+            if (inputCount >= 2) code = WordOpCode::OR;
+            break;
+        case GateType::NOT:
+            if (inputCount >= 1) code = WordOpCode::NOT;
+            break;
+        case GateType::NAND:
+            if (inputCount >= 1) code = inputCount >= 2 ? WordOpCode::NAND : WordOpCode::ONES;
+            break;
+        case GateType::NOR:
+            if (inputCount >= 1) code = inputCount >= 2 ? WordOpCode::NOR : WordOpCode::ONES;
+            break;
+        case GateType::XOR:
+            if (inputCount >= 2) code = WordOpCode::XOR;
+            break;
+        case GateType::OUTPUT:
+            if (inputCount >= 1) code = WordOpCode::COPY;
+            break;
+        default:
+            break;
+    }
+    return WordOp{code, dst, a, b};
+}
+
+void CompiledCircuit::appendWordOps(GateType type, const size_t* drivers, size_t inputCount, uint32_t dst, std::vector<WordOp>& program) {
+    const size_t width = std::min<size_t>(inputCount, MAX_GATE_INPUTS);
+    const uint32_t first = width >= 1 ? static_cast<uint32_t>(drivers[0]) : 0;
+    if (width <= 2 || !isMultiInput(type)) {
+        program.push_back(makeWordOp(type, width, dst, first, width >= 2 ? static_cast<uint32_t>(drivers[1]) : 0));
+        return;
+    }
+
+    GateType accumulate = type;
+    if (type == GateType::NAND) accumulate = GateType::AND;
+    if (type == GateType::NOR) accumulate = GateType::OR;
+    uint32_t a = first;
+    for (size_t k = 1; k + 1 < width; ++k) {
+        program.push_back(makeWordOp(accumulate, 2, dst, a, static_cast<uint32_t>(drivers[k])));
+        a = dst;
+    }
+    program.push_back(makeWordOp(type, 2, dst, a, static_cast<uint32_t>(drivers[width - 1])));
+}
+
+uint64_t CompiledCircuit::inputPattern(int bit, uint64_t firstRow) {
+    static const uint64_t projections[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+                                            0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+    if (bit < 6) return projections[bit];
+    return ((firstRow >> bit) & 1) ? ~0ULL : 0;
+}
+
+void CompiledCircuit::evaluate(std::vector<uint8_t>& states) const {
+    if (!acyclic || stale || states.size() != types.size()) return;
+
+    if (!bytecode.empty()) {
+        bytecode.run(states.data());
+        return;
+    }
+
+    for (size_t gate : order) {
+        if (isSource(types[gate])) continue;
+        states[gate] = evaluateAt(gate, states);
+    }
+}
+
+bool CompiledCircuit::settle(std::vector<uint8_t>& states, std::vector<size_t>* oscillating) const {
+    if (states.size() != types.size()) return true;
+    if (acyclic) {
+        evaluate(states);
+        return true;
+    }
+    if (stale) return true;
+
+    bool settled = true;
+    for (size_t c = 0; c + 1 < componentOffsets.size(); ++c) {
+        if (!feedback[c]) {
+            const size_t gate = componentGates[componentOffsets[c]];
+            if (!isSource(types[gate])) states[gate] = evaluateAt(gate, states);
+            continue;
+        }
+        if (settleComponent(c, states)) continue;
+
+        settled = false;
+        if (oscillating) oscillating->insert(oscillating->end(), componentGates.begin() + componentOffsets[c], componentGates.begin() + componentOffsets[c + 1]);
+    }
+    return settled;
+}
+
+bool CompiledCircuit::settleComponent(size_t component, std::vector<uint8_t>& states) const {
+    const size_t* first = componentGates.data() + componentOffsets[component];
+    const size_t* last = componentGates.data() + componentOffsets[component + 1];
+
+    // Sweeps update states in place. Brent's cycle detection compares each
+    // sweep with a snapshot taken at power-of-two distances, so a loop that
+    // revisits a state is caught after about one period instead of using up
+    // the whole iteration budget.
+    std::vector<uint8_t> snapshot;
+    size_t power = 1;
+    size_t distance = 0;
+    for (int sweep = 0; sweep < MAX_ITERATIONS; ++sweep) {
+        bool changed = false;
+        for (const size_t* gate = first; gate != last; ++gate) {
+            if (isSource(types[*gate])) continue;
+            const uint8_t value = evaluateAt(*gate, states);
+            if (value == states[*gate]) continue;
+            states[*gate] = value;
+            changed = true;
+        }
+        if (!changed) return true;
+
+        if (distance == power) {
+            snapshot.clear();
+            power *= 2;
+            distance = 0;
+        }
+        if (snapshot.empty()) {
+            for (const size_t* gate = first; gate != last; ++gate) snapshot.push_back(states[*gate]);
+        } else if (std::equal(first, last, snapshot.begin(), [&states](size_t gate, uint8_t value) { return states[gate] == value; })) {
+            return false;
+        }
+        ++distance;
+    }
+    return false;
+}
+
+int CompiledCircuit::schedule(size_t gate) {
+    if (queued[gate] || isSource(types[gate])) return maxLevel + 1;
+    queued[gate] = 1;
+    levelQueues[levels[gate]].push_back(gate);
+    return levels[gate];
+}
+
+int CompiledCircuit::scheduleFanOut(size_t gate) {
+    int lowest = maxLevel + 1;
+    const GateSpan loads = getLoads(gate);
+    for (size_t k = 0; k < loads.count; ++k) {
+        lowest = std::min(lowest, schedule(loads.gates[k]));
+    }
+    return lowest;
+}
+
+void CompiledCircuit::propagate(std::vector<uint8_t>& states, const std::vector<size_t>& sources, std::vector<size_t>& changed) {
+    if (!acyclic || states.size() != types.size()) return;
+
+    int level = maxLevel + 1;
+    for (size_t src : sources) {
+        if (src >= types.size()) continue;
+        level = std::min(level, scheduleFanOut(src));
+    }
+    drain(states, level, changed);
+}
+
+void CompiledCircuit::reevaluate(std::vector<uint8_t>& states, const std::vector<size_t>& gates, std::vector<size_t>& changed) {
+    if (!acyclic || states.size() != types.size()) return;
+
+    int level = maxLevel + 1;
+    for (size_t gate : gates) {
+        if (gate >= types.size()) continue;
+        level = std::min(level, schedule(gate));
+    }
+    drain(states, level, changed);
+}
+
+void CompiledCircuit::drain(std::vector<uint8_t>& states, int level, std::vector<size_t>& changed) {
+    // Fan-out always lands on a strictly higher level, so a single upward
+    // sweep drains every queue.
+    for (; level <= maxLevel; ++level) {
+        std::vector<size_t>& queue = levelQueues[level];
+        for (size_t i = 0; i < queue.size(); ++i) {
+            size_t gate = queue[i];
+            queued[gate] = 0;
+
+            uint8_t value = evaluateAt(gate, states);
+            if (value == states[gate]) continue;
+
+            states[gate] = value;
+            changed.push_back(gate);
+            scheduleFanOut(gate);
+        }
+        queue.clear();
+    }
+}
+
+void CompiledCircuit::updateRegisters(std::vector<uint8_t>& states, std::vector<size_t>& changed) {
+    if (states.size() != types.size()) return;
+
+    if (lastClock.size() != registers.size()) {
+        lastClock.assign(registers.size(), 0);
+        for (size_t r = 0; r < registers.size(); ++r) {
+            const size_t clk = getPinSource(registers[r], 1);
+            lastClock[r] = clk != SIZE_MAX && states[clk];
+        }
+        return;
+    }
+
+    sampled.assign(registers.size(), 0);
+    for (size_t r = 0; r < registers.size(); ++r) {
+        const size_t gate = registers[r];
+        const size_t clk = getPinSource(gate, 1);
+        const uint8_t level = clk != SIZE_MAX && states[clk];
+        const size_t d = getPinSource(gate, 0);
+        sampled[r] = level && !lastClock[r] ? (d != SIZE_MAX && states[d]) : states[gate];
+        lastClock[r] = level;
+    }
+
+    for (size_t r = 0; r < registers.size(); ++r) {
+        const size_t gate = registers[r];
+        if (states[gate] == sampled[r]) continue;
+        states[gate] = sampled[r];
+        changed.push_back(gate);
+    }
+}
+
+void CompiledCircuit::evaluateWords(std::vector<uint64_t>& words) const {
+    if (!acyclic || stale || words.size() != types.size()) return;
+
+    if (!bytecode.empty()) {
+        bytecode.run(words.data());
+        return;
+    }
+
+    for (size_t gate : order) {
+        if (isSource(types[gate])) continue;
+
+        if (types[gate] == GateType::LATCH) {
+            const size_t d = getPinSource(gate, 0);
+            const size_t en = getPinSource(gate, 1);
+            const uint64_t enable = en != SIZE_MAX ? words[en] : 0;
+            const uint64_t data = d != SIZE_MAX ? words[d] : 0;
+            words[gate] = (enable & data) | (~enable & words[gate]);
+            continue;
+        }
+
+        const GateSpan drivers = getDrivers(gate);
+        const size_t width = std::min<size_t>(drivers.count, MAX_GATE_INPUTS);
+        uint64_t a = width >= 1 ? words[drivers.gates[0]] : 0;
+        if (isMultiInput(types[gate])) {
+            // Fold all but the last input with the gate's base operator.
+            for (size_t k = 1; k + 1 < width; ++k) {
+                const uint64_t input = words[drivers.gates[k]];
+                if (types[gate] == GateType::AND || types[gate] == GateType::NAND) a &= input;
+                if (types[gate] == GateType::OR || types[gate] == GateType::NOR) a |= input;
+                if (types[gate] == GateType::XOR) a ^= input;
+            }
+        }
+        const uint64_t b = width >= 2 ? words[drivers.gates[width - 1]] : 0;
+        words[gate] = evaluateGateWord(types[gate], width, a, b);
+    }
+}
+
+std::vector<std::vector<uint64_t>> CompiledCircuit::generateTruthTable() const { return generateTruthTable(SimdKernels::detectLevel()); }
+
+std::vector<std::vector<uint64_t>> CompiledCircuit::generateTruthTable(SimdLevel level) const {
+    std::vector<std::vector<uint64_t>> table;
+    if (!isCombinational() || stale || inputGates.size() >= 64) return table;
+
+    const uint64_t numWords = ((1ULL << inputGates.size()) + 63) / 64;
+    table.assign(outputGates.size(), std::vector<uint64_t>(numWords, 0));
+    sweepTruthTable(0, numWords, SimdKernels::getKernel(level), table);
+    return table;
+}
+
+void CompiledCircuit::sweepTruthTable(uint64_t firstWord, uint64_t endWord, SimdKernels::BlockKernel kernel,
+                                      std::vector<std::vector<uint64_t>>& table) const {
+    if (!isCombinational() || stale || inputGates.size() >= 64 || table.size() != outputGates.size()) return;
+
+    const size_t blockWords = SimdKernels::BLOCK_WORDS;
+    const int numInputs = static_cast<int>(inputGates.size());
+    const uint64_t numRows = 1ULL << numInputs;
+    const uint64_t lastMask = numRows >= 64 ? ~0ULL : (1ULL << numRows) - 1;
+
+    std::vector<uint64_t> nets(types.size() * blockWords, 0);
+
+    for (uint64_t blockStart = firstWord; blockStart < endWord; blockStart += blockWords) {
+        for (int j = 0; j < numInputs; ++j) {
+            uint64_t* block = &nets[inputGates[j] * blockWords];
+            for (size_t w = 0; w < blockWords; ++w) {
+                block[w] = inputPattern(numInputs - 1 - j, (blockStart + w) * 64);
+            }
+        }
+
+        kernel(program.data(), program.size(), nets.data());
+
+        const size_t wordsInBlock = static_cast<size_t>(std::min<uint64_t>(blockWords, endWord - blockStart));
+        for (size_t k = 0; k < outputGates.size(); ++k) {
+            const uint64_t* block = &nets[outputGates[k] * blockWords];
+            for (size_t w = 0; w < wordsInBlock; ++w) {
+                table[k][blockStart + w] = block[w] & lastMask;
+            }
+        }
+    }
+}
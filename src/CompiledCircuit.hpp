@@ -0,0 +1,205 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "BytecodeVM.hpp"
+#include "GateType.hpp"
+#include "Netlist.hpp"
+#include "SimdKernels.hpp"
+
+// Levelized view of a circuit. Every gate keeps its drivers (fanIn) and its
+// loads (fanOut), and a level strictly above all of its drivers, so an
+// acyclic circuit can be evaluated in a single O(gates + wires) pass and
+// single changes can be propagated level by level. Edits made through
+// addGate/addConnection/disconnectGate/removeGate update the adjacency in
+// place and re-levelize only the affected cone; the evaluation order and
+// word program are then rebuilt by refresh().
+// DFF outputs are treated like INPUTs when levelizing, so a registered loop
+// still compiles to an acyclic pass; only updateRegisters() moves their state.
+// A circuit with combinational loops is split into strongly connected
+// components instead, so only the gates on a loop need repeated sweeps.
+// Per-gate data is kept as parallel arrays indexed by gate, and states are
+// one byte per gate, so evaluation reads only contiguous hot data.
+class CompiledCircuit {
+   private:
+    std::vector<GateType> types;
+    std::vector<uint8_t> vacant;
+    std::vector<size_t> order;
+    std::vector<int> levels;
+    std::vector<std::vector<size_t>> fanIn;
+    std::vector<std::vector<int>> fanInPins;
+    std::vector<std::vector<size_t>> fanOut;
+    // Flat copies of fanIn and fanOut: gate g's drivers sit at
+    // [fanInOffsets[g], fanInOffsets[g + 1]) of fanInList. Rebuilt with the
+    // program and read instead of the per-gate lists while not stale.
+    std::vector<size_t> fanInOffsets;
+    std::vector<size_t> fanInList;
+    std::vector<size_t> fanOutOffsets;
+    std::vector<size_t> fanOutList;
+    std::vector<size_t> inputGates;
+    std::vector<size_t> outputGates;
+    std::vector<size_t> registers;
+    // Strongly connected components in topological order, only while the
+    // circuit is cyclic: component c is componentGates[componentOffsets[c],
+    // componentOffsets[c + 1]) and feedback[c] is set when it is a loop.
+    std::vector<size_t> componentOffsets;
+    std::vector<size_t> componentGates;
+    std::vector<uint8_t> feedback;
+    std::vector<WordOp> program;
+    BytecodeVM bytecode;
+    int maxLevel = 0;
+    int latchCount = 0;
+    int sequentialCount = 0;
+    bool acyclic = false;
+    bool compiled = false;
+    bool stale = false;
+
+    std::vector<std::vector<size_t>> levelQueues;
+    std::vector<uint8_t> queued;
+    std::vector<uint8_t> lastClock;
+    std::vector<uint8_t> sampled;
+    std::vector<size_t> relevelQueue;
+
+    struct GateSpan {
+        const size_t* gates;
+        size_t count;
+    };
+    GateSpan getDrivers(size_t gate) const {
+        if (stale) return {fanIn[gate].data(), fanIn[gate].size()};
+        return {fanInList.data() + fanInOffsets[gate], fanInOffsets[gate + 1] - fanInOffsets[gate]};
+    }
+    GateSpan getLoads(size_t gate) const {
+        if (stale) return {fanOut[gate].data(), fanOut[gate].size()};
+        return {fanOutList.data() + fanOutOffsets[gate], fanOutOffsets[gate + 1] - fanOutOffsets[gate]};
+    }
+
+    void levelize();
+    void findComponents();
+    bool settleComponent(size_t component, std::vector<uint8_t>& states) const;
+    void flattenAdjacency();
+    void buildProgram();
+    void countGate(GateType type, int delta);
+    void growLevels(int level);
+    int schedule(size_t gate);
+    int scheduleFanOut(size_t gate);
+    void drain(std::vector<uint8_t>& states, int level, std::vector<size_t>& changed);
+    uint64_t packInputs(GateSpan drivers, const std::vector<uint8_t>& states) const;
+
+   public:
+    void compile(const Netlist& netlist);
+    // Places netlist gate i in slot slots[i] (ascending) of a circuit with
+    // slotCount slots; the remaining slots are vacant. Vacant slots read as
+    // unwired INPUTs that are not listed in getInputGates().
+    void compile(const Netlist& netlist, const std::vector<size_t>& slots, size_t slotCount);
+    void invalidate() { compiled = false; }
+
+    // Incremental edits. Gate indices are slots and never shift: addGate
+    // fills the given vacant slot (or appends when slot is SIZE_MAX) and
+    // returns it, and removeGate leaves its slot vacant. disconnectGate and
+    // removeGate append the gates whose drivers changed to affected so
+    // callers can reevaluate().
+    size_t addGate(GateType type, size_t slot = SIZE_MAX);
+    void addConnection(size_t srcGate, size_t dstGate, int dstPin);
+    void disconnectGate(size_t gate, std::vector<size_t>& affected);
+    void removeGate(size_t gate, std::vector<size_t>& affected);
+
+    // Rebuilds the evaluation order, word program and bytecode after edits.
+    // evaluate(), evaluateWords() and the truth-table sweeps do nothing while
+    // isStale(); propagate() and reevaluate() only need the levels.
+    void refresh();
+
+    // Evaluates every non-source gate once in level order; INPUT, CLOCK and
+    // DFF entries of states are read as-is. Only meaningful when isAcyclic().
+    // Runs on the bytecode VM whenever a program could be built.
+    void evaluate(std::vector<uint8_t>& states) const;
+
+    // Evaluation for circuits with feedback. Components are visited in
+    // topological order: a gate outside any loop is evaluated once, and a
+    // loop is swept until it stops changing. A loop that falls into a cycle
+    // of states, or is still changing after MAX_ITERATIONS sweeps, oscillates;
+    // its gates are appended to oscillating and settle() returns false.
+    bool settle(std::vector<uint8_t>& states, std::vector<size_t>* oscillating = nullptr) const;
+    static constexpr int MAX_ITERATIONS = 100;
+
+    // Re-evaluates only the fan-out cone of the given gates, whose entries in
+    // states have already been updated. Gates are visited in level order so
+    // each one is evaluated at most once; gates whose value actually changed
+    // are appended to changed.
+    void propagate(std::vector<uint8_t>& states, const std::vector<size_t>& sources, std::vector<size_t>& changed);
+
+    // Like propagate(), but the given gates themselves are re-evaluated first,
+    // e.g. after their drivers were rewired.
+    void reevaluate(std::vector<uint8_t>& states, const std::vector<size_t>& gates, std::vector<size_t>& changed);
+
+    // Clocks every DFF whose CLK pin rose since the previous call. All D pins
+    // are sampled before any Q changes; updated registers are appended to
+    // changed. The first call after compile() only records the clock levels.
+    void updateRegisters(std::vector<uint8_t>& states, std::vector<size_t>& changed);
+
+    // Bit-parallel variant of evaluate(): every gate holds a 64-bit word, one
+    // bit per input pattern, so a single pass evaluates 64 assignments.
+    void evaluateWords(std::vector<uint64_t>& words) const;
+
+    // Exhaustively sweeps all 2^n assignments of the INPUT gates (first input
+    // is the most significant bit of the row index) and returns one packed
+    // bitset per OUTPUT gate; bit r of word r / 64 is the output for row r.
+    // Rows are processed 512 at a time through the best SIMD kernel the CPU
+    // supports. Returns an empty table unless isCombinational().
+    std::vector<std::vector<uint64_t>> generateTruthTable() const;
+    std::vector<std::vector<uint64_t>> generateTruthTable(SimdLevel level) const;
+
+    // Fills words [firstWord, endWord) of a table shaped like the one returned
+    // by generateTruthTable. firstWord must be a multiple of BLOCK_WORDS.
+    // Disjoint ranges may be swept concurrently.
+    void sweepTruthTable(uint64_t firstWord, uint64_t endWord, SimdKernels::BlockKernel kernel, std::vector<std::vector<uint64_t>>& table) const;
+
+    static WordOp makeWordOp(GateType type, size_t inputCount, uint32_t dst, uint32_t a, uint32_t b);
+    // Word ops for a gate with the given drivers. Wider than two inputs, the
+    // gate's own word accumulates the inputs and the last op applies the gate.
+    static void appendWordOps(GateType type, const size_t* drivers, size_t inputCount, uint32_t dst, std::vector<WordOp>& program);
+
+    // Value of one gate computed from the current states of its drivers.
+    bool evaluateAt(size_t gate, const std::vector<uint8_t>& states) const;
+
+    // Driver of the given pin of a gate, or SIZE_MAX when it is unconnected.
+    size_t getPinSource(size_t gate, int pin) const;
+
+    static bool hasFanIn(GateType type) { return type != GateType::INPUT && type != GateType::CLOCK; }
+    static bool isSource(GateType type) { return type == GateType::INPUT || type == GateType::CLOCK || type == GateType::DFF; }
+    // Inputs are packed one per bit, driver k in bit k, so a gate of any
+    // width is a mask test or a popcount rather than a chain of 2-input ops.
+    static bool evaluateGate(GateType type, size_t inputCount, uint64_t inputs);
+    static uint64_t evaluateGateWord(GateType type, size_t inputCount, uint64_t a, uint64_t b);
+
+    // Word holding the value of row-index bit `bit` for the 64 rows starting at
+    // firstRow (a multiple of 64).
+    static uint64_t inputPattern(int bit, uint64_t firstRow);
+
+    bool isCompiled() const { return compiled; }
+    bool isAcyclic() const { return acyclic; }
+    bool isStale() const { return stale; }
+    bool isSequential() const { return sequentialCount > 0; }
+    bool isCombinational() const { return acyclic && sequentialCount == 0; }
+    // Number of slots, vacant ones included.
+    size_t getGateCount() const { return types.size(); }
+    bool isVacant(size_t gateIndex) const { return vacant[gateIndex]; }
+    int getLevel(size_t gateIndex) const { return levels[gateIndex]; }
+    // Number of combinational loops; 0 when isAcyclic().
+    size_t getFeedbackCount() const { return static_cast<size_t>(std::count(feedback.begin(), feedback.end(), 1)); }
+    const std::vector<size_t>& getOrder() const { return order; }
+    GateType getType(size_t gateIndex) const { return types[gateIndex]; }
+    const size_t* fanOutBegin(size_t gateIndex) const { return getLoads(gateIndex).gates; }
+    const size_t* fanOutEnd(size_t gateIndex) const {
+        const GateSpan loads = getLoads(gateIndex);
+        return loads.gates + loads.count;
+    }
+    const std::vector<size_t>& getFanIn(size_t gateIndex) const { return fanIn[gateIndex]; }
+    const std::vector<size_t>& getInputGates() const { return inputGates; }
+    const std::vector<size_t>& getOutputGates() const { return outputGates; }
+    const std::vector<size_t>& getRegisters() const { return registers; }
+    // Straight-line word program over the non-source gates. Empty when the
+    // circuit is cyclic or contains latches.
+    const std::vector<WordOp>& getProgram() const { return program; }
+    const BytecodeVM& getBytecode() const { return bytecode; }
+};
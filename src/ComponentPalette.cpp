@@ -1,14 +1,17 @@
 #include "ComponentPalette.hpp"
 
+#include <algorithm>
+
 const float LEFT_MARGIN = 50.f;
 const float FONT_INSTRUCTION = 18;
 const float TOP_MARGIN = 40.f;
 const float SPACING = 25.f;
 const float OUTLINE_THICKNESS = 2.f;
 const float BOX_WIDTH = 180.f;
-const float BOX_HEIGHT = 60.f;
+const float BOX_HEIGHT = 45.f;
 const float BOX_Y_SPACING = BOX_HEIGHT + SPACING;
 const float BOX_Y_START = BOX_Y_SPACING + TOP_MARGIN;
+const float SCROLL_STEP = BOX_Y_SPACING;
 
 ComponentPalette::ComponentPalette() {
     sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
@@ -17,7 +20,10 @@ ComponentPalette::ComponentPalette() {
     uiView.setCenter(paletteSize / 2.f);
     uiView.setViewport(sf::FloatRect({0, 0}, {0.18f, 1}));
 
-    type = {GateType::INPUT, GateType::AND, GateType::OR, GateType::NOT, GateType::NAND, GateType::NOR, GateType::XOR, GateType::OUTPUT};
+    type = {GateType::INPUT, GateType::AND, GateType::OR,  GateType::NOT,   GateType::NAND, GateType::NOR,
+            GateType::XOR,   GateType::OUTPUT, GateType::DFF, GateType::LATCH, GateType::CLOCK};
+    module.assign(type.size(), -1);
+    moduleName.assign(type.size(), "");
     setupButtons();
 }
 
@@ -57,7 +63,7 @@ void ComponentPalette::setupTexts() {
 
     for (size_t i = 0; i < type.size(); ++i) {
         sf::Text label(*currentFont);
-        label.setString(getGateTypeName(type[i]));
+        label.setString(type[i] == GateType::MODULE ? moduleName[i] : getGateTypeName(type[i]));
         label.setCharacterSize(18);
         label.setFillColor(sf::Color::Black);
 
@@ -81,7 +87,7 @@ void ComponentPalette::setupTexts() {
 
     float instrStartY = BOX_Y_START + type.size() * BOX_Y_SPACING + SPACING;
     std::vector<std::string> instructions = {"CONTROLS:", "C             Clear", "Esc         Cancel Selection", "Del         Delete",
-                                             "Q            Quit"};
+                                             "+/-         Gate Inputs", "M            Make Module", "Q            Quit"};
 
     for (size_t i = 0; i < instructions.size(); ++i) {
         sf::Text instr(*currentFont);
@@ -94,6 +100,11 @@ void ComponentPalette::setupTexts() {
 }
 
 void ComponentPalette::handleEvent(const sf::Event &event, const sf::RenderWindow &window) {
+    if (const auto *wheel = event.getIf<sf::Event::MouseWheelScrolled>()) {
+        if (wheel->position.x <= window.getSize().x * 0.18f) scrollBy(-wheel->delta * SCROLL_STEP);
+        return;
+    }
+
     if (event.is<sf::Event::MouseMoved>()) {
         sf::Vector2i mousePixel = sf::Mouse::getPosition(window);
         sf::Vector2f mousePos = window.mapPixelToCoords(mousePixel, uiView);
@@ -133,13 +144,29 @@ void ComponentPalette::handleEvent(const sf::Event &event, const sf::RenderWindo
 
 void ComponentPalette::update() { setupButtons(); }
 
+// Module buttons push the controls below the bottom of the screen, so the
+// palette scrolls between its top and the last instruction line.
+void ComponentPalette::scrollBy(float offset) {
+    const float contentBottom = BOX_Y_START + type.size() * BOX_Y_SPACING + SPACING * (instructionTexts.size() + 1) + TOP_MARGIN;
+    const float halfHeight = uiView.getSize().y / 2.f;
+    const float center = std::clamp(uiView.getCenter().y + offset, halfHeight, std::max(halfHeight, contentBottom - halfHeight));
+    uiView.setCenter({uiView.getCenter().x, center});
+}
+
+void ComponentPalette::addModule(const std::string &name, int definition) {
+    type.push_back(GateType::MODULE);
+    module.push_back(definition);
+    moduleName.push_back(name);
+    setupButtons();
+}
+
 void ComponentPalette::draw(sf::RenderWindow &window) {
     window.setView(uiView);
 
     sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
     sf::RectangleShape bg({desktop.size.x * 1.f, desktop.size.y * 1.f});
     bg.setFillColor(sf::Color(200, 200, 200, 200));
-    bg.setPosition({0.f, 0.f});
+    bg.setPosition({0.f, uiView.getCenter().y - uiView.getSize().y / 2.f});
     window.draw(bg);
 
     sf::RectangleShape titleBg({BOX_WIDTH, BOX_HEIGHT});
@@ -179,6 +206,12 @@ std::string ComponentPalette::getGateTypeName(GateType type) const {
             return "XOR";
         case GateType::OUTPUT:
             return "OUTPUT";
+        case GateType::DFF:
+            return "D FLIP-FLOP";
+        case GateType::LATCH:
+            return "D LATCH";
+        case GateType::CLOCK:
+            return "CLOCK";
         default:
             return "UNKNOWN";
     }
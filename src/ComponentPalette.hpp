@@ -10,8 +10,12 @@ class ComponentPalette {
     void setupButtons();
     void setupTexts();
     std::string getGateTypeName(GateType type) const;
+    void scrollBy(float offset);
     std::vector<sf::RectangleShape> buttons;
     std::vector<GateType> type;
+    // Per button: the module definition placed and its name, for MODULE buttons.
+    std::vector<int> module;
+    std::vector<std::string> moduleName;
     int selectedIndex = 0;
     int hoveredIndex = -1;
     sf::View uiView;
@@ -27,4 +31,7 @@ class ComponentPalette {
     void update();
     void draw(sf::RenderWindow &window);
     GateType getSelectedGateType() const;
+    // Definition of the selected MODULE button, -1 for plain gates.
+    int getSelectedModule() const { return module[selectedIndex]; }
+    void addModule(const std::string &name, int definition);
 };
\ No newline at end of file
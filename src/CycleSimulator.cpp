@@ -0,0 +1,100 @@
+#include "CycleSimulator.hpp"
+
+CycleSimulator::CycleSimulator(const Netlist& netlist) {
+    compiled.compile(netlist);
+
+    if (!compiled.isAcyclic()) {
+        error = "combinational feedback loop";
+        return;
+    }
+
+    for (size_t gate = 0; gate < compiled.getGateCount(); ++gate) {
+        if (compiled.getType(gate) == GateType::LATCH) {
+            error = "latch '" + netlist.getName(gate) + "' is not supported in cycle mode";
+            return;
+        }
+    }
+
+    for (size_t gate : compiled.getRegisters()) {
+        const size_t clk = compiled.getPinSource(gate, 1);
+        if (clk == SIZE_MAX || compiled.getType(clk) != GateType::CLOCK) {
+            error = "flip-flop '" + netlist.getName(gate) + "' is not clocked directly by a CLOCK";
+            return;
+        }
+        const size_t d = compiled.getPinSource(gate, 0);
+        registerQ.push_back(static_cast<uint32_t>(gate));
+        // Unconnected D pins read the gate itself, which keeps Q unchanged.
+        registerD.push_back(static_cast<uint32_t>(d != SIZE_MAX ? d : gate));
+    }
+
+    kernel = SimdKernels::getBestKernel();
+    reset();
+}
+
+void CycleSimulator::reset() {
+    nets.assign(compiled.getGateCount() * SimdKernels::BLOCK_WORDS, 0);
+    sampled.assign(registerQ.size() * SimdKernels::BLOCK_WORDS, 0);
+    cycle = 0;
+    settled = false;
+}
+
+void CycleSimulator::setKernel(SimdKernels::BlockKernel blockKernel) {
+    if (!isSupported() || !blockKernel) return;
+    kernel = blockKernel;
+}
+
+void CycleSimulator::setInput(size_t gateIndex, bool value) {
+    if (!isSupported() || gateIndex >= compiled.getGateCount() || compiled.getType(gateIndex) != GateType::INPUT) return;
+
+    uint64_t* block = &nets[gateIndex * SimdKernels::BLOCK_WORDS];
+    for (size_t w = 0; w < SimdKernels::BLOCK_WORDS; ++w) {
+        block[w] = value ? ~0ULL : 0;
+    }
+    settled = false;
+}
+
+void CycleSimulator::setInput(size_t gateIndex, size_t lane, bool value) {
+    if (!isSupported() || gateIndex >= compiled.getGateCount() || compiled.getType(gateIndex) != GateType::INPUT) return;
+    if (lane >= LANES) return;
+
+    uint64_t& word = nets[gateIndex * SimdKernels::BLOCK_WORDS + lane / 64];
+    const uint64_t bit = 1ULL << (lane % 64);
+    word = value ? (word | bit) : (word & ~bit);
+    settled = false;
+}
+
+void CycleSimulator::settle() {
+    kernel(compiled.getProgram().data(), compiled.getProgram().size(), nets.data());
+    settled = true;
+}
+
+void CycleSimulator::step() {
+    if (!isSupported()) return;
+    if (!settled) settle();
+
+    const size_t blockWords = SimdKernels::BLOCK_WORDS;
+    const size_t registerCount = registerQ.size();
+
+    // Sample first so register-to-register paths see the old Q values.
+    for (size_t r = 0; r < registerCount; ++r) {
+        const uint64_t* d = &nets[registerD[r] * blockWords];
+        for (size_t w = 0; w < blockWords; ++w) sampled[r * blockWords + w] = d[w];
+    }
+    for (size_t r = 0; r < registerCount; ++r) {
+        uint64_t* q = &nets[registerQ[r] * blockWords];
+        for (size_t w = 0; w < blockWords; ++w) q[w] = sampled[r * blockWords + w];
+    }
+
+    settle();
+    ++cycle;
+}
+
+void CycleSimulator::run(uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) step();
+}
+
+bool CycleSimulator::getState(size_t gateIndex, size_t lane) {
+    if (!isSupported() || gateIndex >= compiled.getGateCount() || lane >= LANES) return false;
+    if (!settled) settle();
+    return (nets[gateIndex * SimdKernels::BLOCK_WORDS + lane / 64] >> (lane % 64)) & 1;
+}
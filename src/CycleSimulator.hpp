@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CompiledCircuit.hpp"
+#include "Netlist.hpp"
+#include "SimdKernels.hpp"
+
+// Cycle-based simulation of synchronous circuits. All CLOCK gates are taken
+// as one global clock and every DFF must be clocked directly by one, so a
+// cycle is: latch every D into its Q, then run the combinational logic
+// between registers as one straight-line WordOp pass. Each net holds
+// BLOCK_WORDS words, giving LANES independent copies of the circuit that
+// advance together; setInput drives all lanes unless a lane is given.
+// Latches and derived or gated clocks are rejected (see getError()).
+class CycleSimulator {
+   private:
+    CompiledCircuit compiled;
+    SimdKernels::BlockKernel kernel = nullptr;
+    std::vector<uint64_t> nets;
+    std::vector<uint32_t> registerQ;
+    std::vector<uint32_t> registerD;
+    std::vector<uint64_t> sampled;
+    std::string error;
+    uint64_t cycle = 0;
+    bool settled = false;
+
+    void settle();
+
+   public:
+    static constexpr size_t LANES = SimdKernels::BLOCK_WORDS * 64;
+
+    explicit CycleSimulator(const Netlist& netlist);
+
+    bool isSupported() const { return error.empty(); }
+    const std::string& getError() const { return error; }
+
+    // Clears every net and register and restarts at cycle 0.
+    void reset();
+
+    // Replaces the interpreted block kernel, e.g. with NativeCircuit::getKernel().
+    void setKernel(SimdKernels::BlockKernel blockKernel);
+
+    void setInput(size_t gateIndex, bool value);
+    void setInput(size_t gateIndex, size_t lane, bool value);
+
+    // Advances one clock cycle; run() advances count cycles.
+    void step();
+    void run(uint64_t count);
+
+    bool getState(size_t gateIndex, size_t lane = 0);
+    uint64_t getCycle() const { return cycle; }
+    const CompiledCircuit& getCompiled() const { return compiled; }
+};
@@ -0,0 +1,270 @@
+#include "EspressoMinimizer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// The variable to split a cover on: the binate one (appearing in both
+// polarities) with the most literals, else the one with the most literals.
+int splitVariable(const EspressoMinimizer::Cover& f) {
+    int positive[64] = {};
+    int negative[64] = {};
+    for (const EspressoMinimizer::Cube& cube : f) {
+        for (uint64_t bits = cube.zeros ^ cube.ones; bits; bits &= bits - 1) {
+            const int v = __builtin_ctzll(bits);
+            ++((cube.ones >> v) & 1 ? positive : negative)[v];
+        }
+    }
+    int best = -1;
+    std::pair<bool, int> bestScore{false, 0};
+    for (int v = 0; v < 64; ++v) {
+        const std::pair<bool, int> score{positive[v] > 0 && negative[v] > 0, positive[v] + negative[v]};
+        if (score.second > 0 && score > bestScore) {
+            bestScore = score;
+            best = v;
+        }
+    }
+    return best;
+}
+
+// Fewer cubes first, then fewer literals.
+std::pair<size_t, size_t> coverCost(const EspressoMinimizer::Cover& f) {
+    size_t literals = 0;
+    for (const EspressoMinimizer::Cube& cube : f) literals += EspressoMinimizer::literalCount(cube);
+    return {f.size(), literals};
+}
+
+// Indices of f ordered by literal count, largest cubes first unless reversed.
+std::vector<size_t> bySize(const EspressoMinimizer::Cover& f, bool smallestFirst) {
+    std::vector<size_t> order(f.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const int la = EspressoMinimizer::literalCount(f[a]);
+        const int lb = EspressoMinimizer::literalCount(f[b]);
+        return smallestFirst ? la > lb : la < lb;
+    });
+    return order;
+}
+
+void eraseMarked(EspressoMinimizer::Cover& f, const std::vector<uint8_t>& marked) {
+    size_t kept = 0;
+    for (size_t i = 0; i < f.size(); ++i) {
+        if (!marked[i]) f[kept++] = f[i];
+    }
+    f.resize(kept);
+}
+
+}  // namespace
+
+EspressoMinimizer::EspressoMinimizer(int numVars, int timeBudgetMs)
+    : all(numVars >= 64 ? ~0ULL : (1ULL << numVars) - 1), budget(timeBudgetMs) {}
+
+EspressoMinimizer::Cube EspressoMinimizer::literal(int variable, bool value) const {
+    const uint64_t bit = 1ULL << variable;
+    return value ? Cube{all & ~bit, all} : Cube{all, all & ~bit};
+}
+
+bool EspressoMinimizer::intersect(const Cover& a, const Cover& b, Cover& out) const {
+    out.clear();
+    for (const Cube& x : a) {
+        for (const Cube& y : b) {
+            if (!intersects(x, y)) continue;
+            if (out.size() == MAX_CUBES) return false;
+            out.push_back({x.zeros & y.zeros, x.ones & y.ones});
+        }
+    }
+    removeContained(out);
+    return true;
+}
+
+bool EspressoMinimizer::unite(const Cover& a, const Cover& b, Cover& out) const {
+    if (a.size() + b.size() > MAX_CUBES) return false;
+    out = a;
+    out.insert(out.end(), b.begin(), b.end());
+    removeContained(out);
+    return true;
+}
+
+bool EspressoMinimizer::complement(const Cover& cover, Cover& out) const {
+    Cover f = cover;
+    removeContained(f);
+    return complementRecursive(f, out);
+}
+
+// Shannon expansion: ~f = ~v.~f(v=0) + v.~f(v=1), where a cube found in both
+// halves is kept once without v.
+bool EspressoMinimizer::complementRecursive(const Cover& f, Cover& out) const {
+    out.clear();
+    if (f.empty()) {
+        out.push_back(universe());
+        return true;
+    }
+    for (const Cube& cube : f) {
+        if (isUniverse(cube)) return true;
+    }
+    if (f.size() == 1) {
+        for (uint64_t bits = f[0].zeros ^ f[0].ones; bits; bits &= bits - 1) {
+            const int v = __builtin_ctzll(bits);
+            out.push_back(literal(v, !((f[0].ones >> v) & 1)));
+        }
+        return true;
+    }
+
+    const int v = splitVariable(f);
+    Cover low;
+    Cover high;
+    if (!complementRecursive(cofactor(f, literal(v, false)), low) || !complementRecursive(cofactor(f, literal(v, true)), high)) return false;
+
+    auto less = [](const Cube& a, const Cube& b) { return a.zeros != b.zeros ? a.zeros < b.zeros : a.ones < b.ones; };
+    std::sort(low.begin(), low.end(), less);
+    std::sort(high.begin(), high.end(), less);
+    const uint64_t bit = 1ULL << v;
+    size_t h = 0;
+    for (const Cube& cube : low) {
+        for (; h < high.size() && less(high[h], cube); ++h) out.push_back({high[h].zeros & ~bit, high[h].ones});
+        if (h < high.size() && !less(cube, high[h])) {
+            out.push_back(cube);
+            ++h;
+        } else {
+            out.push_back({cube.zeros, cube.ones & ~bit});
+        }
+    }
+    for (; h < high.size(); ++h) out.push_back({high[h].zeros & ~bit, high[h].ones});
+    if (out.size() > MAX_CUBES) return false;
+    removeContained(out);
+    return true;
+}
+
+EspressoMinimizer::Cover EspressoMinimizer::cofactor(const Cover& f, const Cube& p, const std::vector<uint8_t>* dropped) const {
+    Cover result;
+    const uint64_t freeZeros = all & ~p.zeros;
+    const uint64_t freeOnes = all & ~p.ones;
+    for (size_t i = 0; i < f.size(); ++i) {
+        if ((dropped && (*dropped)[i]) || !intersects(f[i], p)) continue;
+        result.push_back({f[i].zeros | freeZeros, f[i].ones | freeOnes});
+    }
+    return result;
+}
+
+// A cover unate in v (v in one polarity only) is a tautology exactly when
+// its cubes without v are, so those variables are cleared first; the rest is
+// split on its most binate variable.
+bool EspressoMinimizer::isTautology(Cover f) const {
+    for (;;) {
+        uint64_t negative = 0;
+        uint64_t positive = 0;
+        for (const Cube& cube : f) {
+            if (isUniverse(cube)) return true;
+            negative |= all & ~cube.ones;
+            positive |= all & ~cube.zeros;
+        }
+        const uint64_t unate = negative ^ positive;
+        if (!unate) break;
+        f.erase(std::remove_if(f.begin(), f.end(), [&](const Cube& cube) { return (cube.zeros ^ cube.ones) & unate; }), f.end());
+    }
+    if (f.empty()) return false;
+
+    const int v = splitVariable(f);
+    return isTautology(cofactor(f, literal(v, false))) && isTautology(cofactor(f, literal(v, true)));
+}
+
+void EspressoMinimizer::removeContained(Cover& cover) {
+    std::stable_sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) { return literalCount(a) < literalCount(b); });
+    Cover kept;
+    for (const Cube& cube : cover) {
+        if (std::none_of(kept.begin(), kept.end(), [&](const Cube& outer) { return contains(outer, cube); })) kept.push_back(cube);
+    }
+    cover = std::move(kept);
+}
+
+// Raises the literals of each cube, largest cubes first, as long as the cube
+// stays inside the cover; literals whose removal alone would swallow the
+// most other cubes are tried first. Swallowed cubes are dropped.
+void EspressoMinimizer::expand(Cover& f, Clock::time_point deadline) const {
+    std::vector<uint8_t> covered(f.size(), 0);
+    for (size_t i : bySize(f, false)) {
+        if (covered[i]) continue;
+        if (Clock::now() > deadline) break;
+
+        Cube cube = f[i];
+        std::vector<std::pair<int, int>> candidates;
+        for (uint64_t bits = cube.zeros ^ cube.ones; bits; bits &= bits - 1) {
+            const int v = __builtin_ctzll(bits);
+            const Cube raised{cube.zeros | (1ULL << v), cube.ones | (1ULL << v)};
+            int gain = 0;
+            for (size_t j = 0; j < f.size(); ++j) gain += j != i && !covered[j] && contains(raised, f[j]);
+            candidates.push_back({-gain, v});
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (const auto& candidate : candidates) {
+            const uint64_t bit = 1ULL << candidate.second;
+            const Cube raised{cube.zeros | bit, cube.ones | bit};
+            if (isTautology(cofactor(f, raised, &covered))) cube = raised;
+        }
+        f[i] = cube;
+        for (size_t j = 0; j < f.size(); ++j) {
+            if (j != i && !covered[j] && contains(cube, f[j])) covered[j] = 1;
+        }
+    }
+    eraseMarked(f, covered);
+}
+
+// Drops cubes covered by the others, smallest cubes first.
+void EspressoMinimizer::irredundant(Cover& f, Clock::time_point deadline) const {
+    std::vector<uint8_t> dropped(f.size(), 0);
+    for (size_t i : bySize(f, true)) {
+        if (Clock::now() > deadline) break;
+        dropped[i] = 1;
+        if (!isTautology(cofactor(f, f[i], &dropped))) dropped[i] = 0;
+    }
+    eraseMarked(f, dropped);
+}
+
+// Shrinks each cube, largest first, to the smallest cube holding the points
+// no other cube covers, so the next EXPAND can grow it in a new direction.
+// A half of the cube may be cut off exactly when the rest covers it.
+void EspressoMinimizer::reduce(Cover& f, Clock::time_point deadline) const {
+    std::vector<uint8_t> dropped(f.size(), 0);
+    for (size_t i : bySize(f, false)) {
+        if (Clock::now() > deadline) break;
+        dropped[i] = 1;
+        Cube cube = f[i];
+        const Cover rest = cofactor(f, cube, &dropped);
+        if (isTautology(rest)) continue;
+
+        for (uint64_t bits = cube.zeros & cube.ones; bits; bits &= bits - 1) {
+            const uint64_t bit = bits & (~bits + 1);
+            const Cube low{cube.zeros, cube.ones & ~bit};
+            const Cube high{cube.zeros & ~bit, cube.ones};
+            if (isTautology(cofactor(rest, low))) {
+                cube = high;
+            } else if (isTautology(cofactor(rest, high))) {
+                cube = low;
+            }
+        }
+        f[i] = cube;
+        dropped[i] = 0;
+    }
+    eraseMarked(f, dropped);
+}
+
+EspressoMinimizer::Cover EspressoMinimizer::minimize(const Cover& cover) const {
+    const Clock::time_point deadline = Clock::now() + budget;
+    Cover f = cover;
+    removeContained(f);
+    if (f.empty() || isUniverse(f[0])) return f;
+
+    expand(f, deadline);
+    irredundant(f, deadline);
+    Cover best = f;
+    while (Clock::now() < deadline) {
+        reduce(f, deadline);
+        expand(f, deadline);
+        irredundant(f, deadline);
+        if (coverCost(f) >= coverCost(best)) break;
+        best = f;
+    }
+    return coverCost(f) < coverCost(best) ? f : best;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Heuristic two-level minimizer in the style of Espresso. A sum of products
+// is a list of cubes over up to 64 variables and is improved by repeating
+// REDUCE, EXPAND and IRREDUNDANT while the cube and literal counts go down.
+// Containment is decided by tautology checks on the cover itself, so no
+// truth table or OFF-set is ever built. Every cube of the result is prime
+// and none is redundant, but the cover is not always a minimum one.
+class EspressoMinimizer {
+   public:
+    // Bit v of zeros / ones is set when the cube holds points with variable
+    // v = 0 / 1: both for a variable the term does not mention, one for a
+    // literal. A cube with neither bit for some variable is empty.
+    struct Cube {
+        uint64_t zeros;
+        uint64_t ones;
+    };
+    using Cover = std::vector<Cube>;
+
+    static constexpr int MAX_VARIABLES = 64;
+    // Cover algebra gives up on results larger than this.
+    static constexpr size_t MAX_CUBES = 1 << 12;
+    static constexpr int DEFAULT_TIME_BUDGET_MS = 100;
+
+    explicit EspressoMinimizer(int numVars, int timeBudgetMs = DEFAULT_TIME_BUDGET_MS);
+
+    Cube universe() const { return {all, all}; }
+    Cube literal(int variable, bool value) const;
+    bool isUniverse(const Cube& cube) const { return cube.zeros == all && cube.ones == all; }
+
+    // Cover algebra for building an ON-set. Each returns false if the result
+    // would exceed MAX_CUBES; out is then unspecified.
+    bool intersect(const Cover& a, const Cover& b, Cover& out) const;
+    bool unite(const Cover& a, const Cover& b, Cover& out) const;
+    bool complement(const Cover& cover, Cover& out) const;
+
+    // An equivalent cover with fewer cubes and literals. Improvement stops
+    // once the time budget is spent.
+    Cover minimize(const Cover& cover) const;
+
+    static int literalCount(const Cube& cube) { return __builtin_popcountll(cube.zeros ^ cube.ones); }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t all;
+    std::chrono::milliseconds budget;
+
+    static bool contains(const Cube& outer, const Cube& inner) {
+        return !(inner.zeros & ~outer.zeros) && !(inner.ones & ~outer.ones);
+    }
+    bool intersects(const Cube& a, const Cube& b) const { return ((a.zeros & b.zeros) | (a.ones & b.ones)) == all; }
+
+    // Cubes of f meeting p with p's literals dropped, skipping those marked
+    // in dropped (if given).
+    Cover cofactor(const Cover& f, const Cube& p, const std::vector<uint8_t>* dropped = nullptr) const;
+    bool isTautology(Cover f) const;
+    bool complementRecursive(const Cover& f, Cover& out) const;
+    static void removeContained(Cover& cover);
+
+    void expand(Cover& f, Clock::time_point deadline) const;
+    void irredundant(Cover& f, Clock::time_point deadline) const;
+    void reduce(Cover& f, Clock::time_point deadline) const;
+};
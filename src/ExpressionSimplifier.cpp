@@ -1,9 +1,11 @@
 #include "ExpressionSimplifier.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
 #include <iostream>
 #include <sstream>
-#include <stack>
 #include <unordered_set>
 
 std::string ExpressionSimplifier::simplifyExpression(const std::string& expression) const {
@@ -14,7 +16,7 @@ std::string ExpressionSimplifier::simplifyExpression(const std::string& expressi
     std::string standardForm = convertToStandardForm(expression);
 
     if (standardForm.find('^') != std::string::npos) {
-        std::set<char> variables = getVariables(standardForm);
+        std::vector<std::string> variables = getVariables(standardForm);
         size_t xorCount = std::count(standardForm.begin(), standardForm.end(), '^');
 
         if (variables.size() <= 3 && xorCount >= 1 && standardForm.find('+') == std::string::npos && standardForm.find('.') == std::string::npos) {
@@ -28,7 +30,15 @@ std::string ExpressionSimplifier::simplifyExpression(const std::string& expressi
         return expression;
     }
 
-    std::vector<std::vector<int>> truthTable = generateTruthTable(standardForm, numVars);
+    if (engine == MinimizationEngine::Heuristic || (engine == MinimizationEngine::Auto && numVars > MAX_SIMPLIFY_VARIABLES)) {
+        return numVars > EspressoMinimizer::MAX_VARIABLES ? standardForm : minimizeHeuristic(standardForm, numVars);
+    }
+
+    if (numVars > MAX_SIMPLIFY_VARIABLES) {
+        return standardForm;
+    }
+
+    std::vector<uint64_t> truthTable = generateTruthTable(compileExpression(standardForm, getVariables(standardForm)), numVars);
 
     std::vector<int> minterms = extractMinterms(truthTable);
 
@@ -36,11 +46,11 @@ std::string ExpressionSimplifier::simplifyExpression(const std::string& expressi
         return "0";
     }
 
-    if (minterms.size() == (1 << numVars)) {
+    if (minterms.size() == (size_t{1} << numVars)) {
         return "1";
     }
 
-    return quineMcCluskey(minterms, numVars, standardForm);
+    return quineMcCluskey(truthTable, minterms, numVars, standardForm);
 }
 
 std::vector<std::string> ExpressionSimplifier::generateTruthTableDisplay(const std::string& expression) const {
@@ -58,38 +68,40 @@ std::vector<std::string> ExpressionSimplifier::generateTruthTableDisplay(const s
         result.push_back("No variables found");
         return result;
     }
+    if (numVars > MAX_TABLE_VARIABLES) {
+        result.push_back("Too many variables");
+        return result;
+    }
 
-    std::set<char> variables = getVariables(standardForm);
-    std::vector<char> varList(variables.begin(), variables.end());
-    std::sort(varList.begin(), varList.end());
+    std::vector<std::string> varList = getVariables(standardForm);
 
     std::string header = "|";
-    for (char var : varList) {
-        header += " " + std::string(1, var) + " |";
+    for (const std::string& var : varList) {
+        header += " " + var + " |";
     }
     header += " Output |";
     result.push_back(header);
 
     std::string separator = "|";
-    for (size_t i = 0; i < varList.size(); i++) {
-        separator += "---|";
+    for (const std::string& var : varList) {
+        separator += std::string(var.size() + 2, '-') + "|";
     }
     separator += "--------|";
     result.push_back(separator);
 
+    const std::vector<uint64_t> table = generateTruthTable(compileExpression(standardForm, varList), numVars);
+
     int numRows = 1 << numVars;
     for (int i = 0; i < numRows; i++) {
-        std::map<char, bool> values;
         std::string row = "|";
 
         for (int j = 0; j < numVars; j++) {
-            char var = varList[j];
+            const std::string& var = varList[j];
             bool value = (i >> (numVars - 1 - j)) & 1;
-            values[var] = value;
-            row += " " + std::string(value ? "1" : "0") + " |";
+            row += " " + std::string(var.size() - 1, ' ') + (value ? "1" : "0") + " |";
         }
 
-        bool output = evaluateExpression(standardForm, values);
+        bool output = (table[i / 64] >> (i % 64)) & 1;
         row += "   " + std::string(output ? "1" : "0") + "    |";
         result.push_back(row);
     }
@@ -105,29 +117,29 @@ std::vector<std::string> ExpressionSimplifier::generateMultiOutputTruthTable(con
         return result;
     }
 
-    std::set<char> allVariables;
     std::vector<std::string> validExpressions;
 
     for (const std::string& expr : expressions) {
         if (!expr.empty() && isValidExpression(expr) && expr != "0") {
             validExpressions.push_back(expr);
-            std::set<char> exprVars = getVariables(expr);
-            allVariables.insert(exprVars.begin(), exprVars.end());
         }
     }
 
-    if (validExpressions.empty() || allVariables.empty()) {
+    std::vector<std::string> varList = getVariables(validExpressions);
+    if (validExpressions.empty() || varList.empty()) {
         result.push_back("No valid expressions found");
         return result;
     }
 
-    std::vector<char> varList(allVariables.begin(), allVariables.end());
-    std::sort(varList.begin(), varList.end());
     int numVars = static_cast<int>(varList.size());
+    if (numVars > MAX_TABLE_VARIABLES) {
+        result.push_back("Too many variables");
+        return result;
+    }
 
     std::string header = "|";
-    for (char var : varList) {
-        header += " " + std::string(1, var) + " |";
+    for (const std::string& var : varList) {
+        header += " " + var + " |";
     }
     for (size_t i = 0; i < validExpressions.size(); i++) {
         header += " Out" + std::to_string(i + 1) + " |";
@@ -135,28 +147,31 @@ std::vector<std::string> ExpressionSimplifier::generateMultiOutputTruthTable(con
     result.push_back(header);
 
     std::string separator = "|";
-    for (size_t i = 0; i < varList.size(); i++) {
-        separator += "---|";
+    for (const std::string& var : varList) {
+        separator += std::string(var.size() + 2, '-') + "|";
     }
     for (size_t i = 0; i < validExpressions.size(); i++) {
         separator += "-----|";
     }
     result.push_back(separator);
 
+    std::vector<std::vector<uint64_t>> tables;
+    for (const std::string& expr : validExpressions) {
+        tables.push_back(generateTruthTable(compileExpression(convertToStandardForm(expr), varList), numVars));
+    }
+
     int numRows = 1 << numVars;
     for (int i = 0; i < numRows; i++) {
-        std::map<char, bool> values;
         std::string row = "|";
 
         for (int j = 0; j < numVars; j++) {
-            char var = varList[j];
+            const std::string& var = varList[j];
             bool value = (i >> (numVars - 1 - j)) & 1;
-            values[var] = value;
-            row += " " + std::string(value ? "1" : "0") + " |";
+            row += " " + std::string(var.size() - 1, ' ') + (value ? "1" : "0") + " |";
         }
 
-        for (const std::string& expr : validExpressions) {
-            bool output = evaluateExpression(convertToStandardForm(expr), values);
+        for (const std::vector<uint64_t>& table : tables) {
+            bool output = (table[i / 64] >> (i % 64)) & 1;
             row += "  " + std::string(output ? "1" : "0") + "  |";
         }
 
@@ -166,144 +181,451 @@ std::vector<std::string> ExpressionSimplifier::generateMultiOutputTruthTable(con
     return result;
 }
 
-std::vector<std::vector<int>> ExpressionSimplifier::generateTruthTable(const std::string& expression, int numVars) const {
-    std::vector<std::vector<int>> table;
-    std::set<char> variables = getVariables(expression);
-    std::vector<char> varList(variables.begin(), variables.end());
-    std::sort(varList.begin(), varList.end());
-
-    int numRows = 1 << numVars;
-    for (int i = 0; i < numRows; i++) {
-        std::vector<int> row;
-        std::map<char, bool> values;
+std::vector<uint64_t> ExpressionSimplifier::generateTruthTable(const CompiledExpression& compiled, int numVars) const {
+    const uint64_t numRows = 1ULL << numVars;
+    std::vector<uint64_t> table((numRows + 63) / 64);
 
-        for (int j = 0; j < numVars; j++) {
-            char var = varList[j];
-            bool value = (i >> (numVars - 1 - j)) & 1;
-            values[var] = value;
-            row.push_back(value ? 1 : 0);
-        }
-
-        bool output = evaluateExpression(expression, values);
-        row.push_back(output ? 1 : 0);
-        table.push_back(row);
+    for (size_t w = 0; w < table.size(); ++w) {
+        table[w] = compiled.evaluateWord(w * 64);
     }
+    if (numRows < 64) table[0] &= (1ULL << numRows) - 1;
 
     return table;
 }
 
-std::vector<int> ExpressionSimplifier::extractMinterms(const std::vector<std::vector<int>>& truthTable) const {
+std::vector<int> ExpressionSimplifier::extractMinterms(const std::vector<uint64_t>& truthTable) const {
     std::vector<int> minterms;
 
-    for (size_t i = 0; i < truthTable.size(); i++) {
-        const auto& row = truthTable[i];
-        if (!row.empty() && row.back() == 1) {
-            minterms.push_back(static_cast<int>(i));
+    for (size_t w = 0; w < truthTable.size(); ++w) {
+        for (uint64_t bits = truthTable[w]; bits; bits &= bits - 1) {
+            minterms.push_back(static_cast<int>(w * 64 + __builtin_ctzll(bits)));
         }
     }
 
     return minterms;
 }
 
-std::string ExpressionSimplifier::quineMcCluskey(const std::vector<int>& minterms, int numVars, const std::string& expression) const {
+std::string ExpressionSimplifier::quineMcCluskey(const std::vector<uint64_t>& truthTable, const std::vector<int>& minterms, int numVars,
+                                                 const std::string& expression) const {
     if (minterms.empty()) {
         return "0";
     }
 
-    std::vector<Implicant> primeImplicants = findPrimeImplicants(minterms, numVars);
+    std::vector<Implicant> primeImplicants = findPrimeImplicants(truthTable, numVars);
 
-    return generateSimplifiedExpression(primeImplicants, minterms, numVars, expression);
+    return generateSimplifiedExpression(selectCover(primeImplicants, minterms, numVars), numVars, expression);
 }
 
-std::vector<std::vector<ExpressionSimplifier::Implicant>> ExpressionSimplifier::groupByOnes(const std::vector<int>& minterms, int numVars) const {
-    std::vector<std::vector<Implicant>> groups(numVars + 1);
+namespace {
 
-    for (int minterm : minterms) {
-        std::string binary = "";
-        for (int i = numVars - 1; i >= 0; i--) {
-            binary += ((minterm >> i) & 1) ? '1' : '0';
-        }
+// Repeating runs of 2^k ones and 2^k zeros.
+constexpr uint64_t RUNS[6] = {0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+                              0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL};
 
-        int ones = countOnes(binary);
-        groups[ones].emplace_back(std::vector<int>{minterm}, binary);
+// Entry u of out is entry u ^ (1 << bit) of table; tables are bitsets
+// indexed by u, or the low 2^k bits of one word when smaller.
+void flipIndexBit(const std::vector<uint64_t>& table, int bit, std::vector<uint64_t>& out) {
+    out.resize(table.size());
+    if (bit >= 6) {
+        const size_t stride = size_t(1) << (bit - 6);
+        for (size_t w = 0; w < table.size(); ++w) out[w] = table[w ^ stride];
+        return;
+    }
+    const int shift = 1 << bit;
+    for (size_t w = 0; w < table.size(); ++w) {
+        out[w] = ((table[w] >> shift) & RUNS[bit]) | ((table[w] & RUNS[bit]) << shift);
     }
+}
 
-    return groups;
+// Packs the 32 entries of a word whose index bit is 0 into its low half.
+uint64_t compressWord(uint64_t word, int bit) {
+    word &= RUNS[bit];
+    for (int k = bit; k < 5; ++k) word = (word | (word >> (1 << k))) & RUNS[k + 1];
+    return word;
 }
 
-std::vector<ExpressionSimplifier::Implicant> ExpressionSimplifier::findPrimeImplicants(const std::vector<int>& minterms, int numVars) const {
-    std::vector<std::vector<Implicant>> currentGroups = groupByOnes(minterms, numVars);
-    std::vector<Implicant> primeImplicants;
+// Keeps the entries whose index bit is 0, re-indexed without that bit.
+void dropIndexBit(const std::vector<uint64_t>& table, int bit, std::vector<uint64_t>& out) {
+    out.assign(std::max<size_t>(1, table.size() / 2), 0);
+    if (bit >= 6) {
+        const size_t stride = size_t(1) << (bit - 6);
+        size_t next = 0;
+        for (size_t block = 0; block < table.size(); block += 2 * stride) {
+            for (size_t w = block; w < block + stride; ++w) out[next++] = table[w];
+        }
+        return;
+    }
+    if (table.size() == 1) {
+        out[0] = compressWord(table[0], bit);
+        return;
+    }
+    for (size_t w = 0; w < out.size(); ++w) {
+        out[w] = compressWord(table[2 * w], bit) | (compressWord(table[2 * w + 1], bit) << 32);
+    }
+}
 
-    while (true) {
-        std::vector<std::vector<Implicant>> nextGroups(numVars + 1);
-        bool combined = false;
+}  // namespace
 
-        for (int i = 0; i < numVars; i++) {
-            for (const auto& imp1 : currentGroups[i]) {
-                for (const auto& imp2 : currentGroups[i + 1]) {
-                    if (canCombine(imp1.pattern, imp2.pattern)) {
-                        std::string newPattern = combinePatterns(imp1.pattern, imp2.pattern);
-                        std::vector<int> newTerms = imp1.terms;
-                        newTerms.insert(newTerms.end(), imp2.terms.begin(), imp2.terms.end());
+std::vector<ExpressionSimplifier::Implicant> ExpressionSimplifier::findPrimeImplicants(const std::vector<uint64_t>& truthTable, int numVars) const {
+    std::vector<Implicant> primeImplicants;
+    collectPrimeImplicants(truthTable, 0, numVars, primeImplicants);
+    return primeImplicants;
+}
 
-                        nextGroups[i].emplace_back(newTerms, newPattern);
-                        combined = true;
+// The cubes sharing one mask are a bitset over the values of the remaining
+// free variables, so every merge of a Quine-McCluskey round is a word-wide
+// AND: (v, M + b) is an implicant exactly when (v, M) and (v | b, M) are.
+// Each mask is built once, from the mask without its highest bit, and a
+// bitset cannot hold the same cube twice. A cube is prime when it merges
+// along no free variable.
+void ExpressionSimplifier::collectPrimeImplicants(const std::vector<uint64_t>& cubes, uint32_t mask, int numVars,
+                                                  std::vector<Implicant>& primes) const {
+    std::vector<int> freeBits;
+    for (int bit = 0; bit < numVars; ++bit) {
+        if (!(mask & (1u << bit))) freeBits.push_back(bit);
+    }
+    const int highest = mask ? 31 - __builtin_clz(mask) : -1;
+
+    std::vector<uint64_t> mergeable(cubes.size(), 0);
+    std::vector<uint64_t> merged;
+    std::vector<uint64_t> child;
+    for (int index = 0; index < static_cast<int>(freeBits.size()); ++index) {
+        flipIndexBit(cubes, index, merged);
+        bool any = false;
+        for (size_t w = 0; w < cubes.size(); ++w) {
+            merged[w] &= cubes[w];
+            mergeable[w] |= merged[w];
+            any = any || merged[w];
+        }
+        if (!any || freeBits[index] < highest) continue;
 
-                        const_cast<Implicant&>(imp1).used = true;
-                        const_cast<Implicant&>(imp2).used = true;
-                    }
-                }
+        dropIndexBit(merged, index, child);
+        collectPrimeImplicants(child, mask | (1u << freeBits[index]), numVars, primes);
+    }
+
+    for (size_t w = 0; w < cubes.size(); ++w) {
+        for (uint64_t bits = cubes[w] & ~mergeable[w]; bits; bits &= bits - 1) {
+            const uint64_t free = w * 64 + __builtin_ctzll(bits);
+            uint32_t value = 0;
+            for (size_t index = 0; index < freeBits.size(); ++index) {
+                if ((free >> index) & 1) value |= 1u << freeBits[index];
             }
+            primes.push_back({value, mask});
         }
+    }
+}
 
-        for (const auto& group : currentGroups) {
-            for (const auto& imp : group) {
-                if (!imp.used) {
-                    primeImplicants.push_back(imp);
-                }
-            }
+namespace {
+
+// Rows still to be covered by a choice of columns, every set as a bitset:
+// columns[c] holds the rows column c covers and rowColumns[r] the columns
+// covering row r.
+class CoverSearch {
+   private:
+    size_t rowWords;
+    size_t columnWords;
+    std::vector<std::vector<uint64_t>> columns;
+    std::vector<std::vector<uint64_t>> rowColumns;
+    std::vector<int> costs;
+    std::vector<uint64_t> uncovered;
+    std::vector<uint64_t> activeColumns;
+    std::vector<uint32_t> selected;
+    std::chrono::steady_clock::time_point deadline;
+
+    std::vector<uint32_t> best;
+    int bestCost = INT32_MAX;
+
+    static bool test(const std::vector<uint64_t>& bits, size_t i) { return (bits[i / 64] >> (i % 64)) & 1; }
+    static void reset(std::vector<uint64_t>& bits, size_t i) { bits[i / 64] &= ~(1ULL << (i % 64)); }
+    static bool isSubset(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+        for (size_t w = 0; w < a.size(); ++w) {
+            if (a[w] & ~b[w]) return false;
         }
+        return true;
+    }
 
-        if (!combined) {
-            break;
+    void dropRow(size_t row) {
+        reset(uncovered, row);
+        for (auto& column : columns) reset(column, row);
+    }
+    void dropColumn(size_t column) {
+        reset(activeColumns, column);
+        for (auto& row : rowColumns) reset(row, column);
+    }
+    void select(size_t column) {
+        selected.push_back(static_cast<uint32_t>(column));
+        for (size_t w = 0; w < rowWords; ++w) {
+            for (uint64_t bits = columns[column][w]; bits; bits &= bits - 1) dropRow(w * 64 + __builtin_ctzll(bits));
+        }
+        dropColumn(column);
+    }
+    template <typename Visit>
+    static void forEach(const std::vector<uint64_t>& bits, Visit visit) {
+        for (size_t w = 0; w < bits.size(); ++w) {
+            for (uint64_t word = bits[w]; word; word &= word - 1) visit(w * 64 + __builtin_ctzll(word));
+        }
+    }
+
+    bool reduceOnce(bool dominance);
+    void greedy();
+    void search(const std::vector<uint64_t>& open, int cost, std::vector<uint32_t>& picked);
+
+   public:
+    CoverSearch(const std::vector<std::vector<uint32_t>>& coverage, const std::vector<int>& costs, size_t rowCount,
+                std::chrono::steady_clock::time_point deadline);
+
+    // Columns of a cheapest cover, or the cheapest found before the deadline.
+    std::vector<uint32_t> solve();
+};
+
+CoverSearch::CoverSearch(const std::vector<std::vector<uint32_t>>& coverage, const std::vector<int>& costs, size_t rowCount,
+                         std::chrono::steady_clock::time_point deadline)
+    : rowWords((rowCount + 63) / 64), columnWords((coverage.size() + 63) / 64), costs(costs), deadline(deadline) {
+    columns.assign(coverage.size(), std::vector<uint64_t>(rowWords, 0));
+    rowColumns.assign(rowCount, std::vector<uint64_t>(columnWords, 0));
+    for (size_t c = 0; c < coverage.size(); ++c) {
+        for (uint32_t row : coverage[c]) {
+            columns[c][row / 64] |= 1ULL << (row % 64);
+            rowColumns[row][c / 64] |= 1ULL << (c % 64);
         }
+    }
+    uncovered.assign(rowWords, 0);
+    for (size_t row = 0; row < rowCount; ++row) uncovered[row / 64] |= 1ULL << (row % 64);
+    activeColumns.assign(columnWords, 0);
+    for (size_t c = 0; c < coverage.size(); ++c) activeColumns[c / 64] |= 1ULL << (c % 64);
+}
+
+// One pass of essential columns, then dominated columns (covering a subset
+// of another column's rows at no lower cost) and dominated rows (covered
+// whenever some other row is). Returns whether anything changed.
+bool CoverSearch::reduceOnce(bool dominance) {
+    bool changed = false;
+    forEach(uncovered, [&](size_t row) {
+        if (!test(uncovered, row)) return;
+        size_t count = 0;
+        size_t only = 0;
+        forEach(rowColumns[row], [&](size_t column) {
+            ++count;
+            only = column;
+        });
+        if (count != 1) return;
+        select(only);
+        changed = true;
+    });
+    if (!dominance) return changed;
+
+    forEach(activeColumns, [&](size_t a) {
+        forEach(activeColumns, [&](size_t b) {
+            if (a == b || !test(activeColumns, a) || !test(activeColumns, b) || costs[b] > costs[a]) return;
+            if (!isSubset(columns[a], columns[b])) return;
+            // Equal columns of equal cost: keep the lower index.
+            if (costs[b] == costs[a] && b > a && isSubset(columns[b], columns[a])) return;
+            dropColumn(a);
+            changed = true;
+        });
+    });
+
+    forEach(uncovered, [&](size_t r1) {
+        forEach(uncovered, [&](size_t r2) {
+            if (r1 == r2 || !test(uncovered, r1) || !test(uncovered, r2)) return;
+            if (!isSubset(rowColumns[r1], rowColumns[r2])) return;
+            if (r2 < r1 && isSubset(rowColumns[r2], rowColumns[r1])) return;
+            dropRow(r2);
+            changed = true;
+        });
+    });
+    return changed;
+}
 
-        currentGroups = nextGroups;
+// Cheapest cost per newly covered row first; seeds the bound for search().
+void CoverSearch::greedy() {
+    std::vector<uint64_t> open = uncovered;
+    std::vector<uint32_t> picked;
+    int cost = 0;
+    while (std::any_of(open.begin(), open.end(), [](uint64_t w) { return w != 0; })) {
+        size_t bestColumn = 0;
+        double bestRatio = -1;
+        forEach(activeColumns, [&](size_t column) {
+            int gain = 0;
+            for (size_t w = 0; w < rowWords; ++w) gain += __builtin_popcountll(columns[column][w] & open[w]);
+            const double ratio = static_cast<double>(gain) / costs[column];
+            if (ratio > bestRatio) {
+                bestRatio = ratio;
+                bestColumn = column;
+            }
+        });
+        picked.push_back(static_cast<uint32_t>(bestColumn));
+        cost += costs[bestColumn];
+        for (size_t w = 0; w < rowWords; ++w) open[w] &= ~columns[bestColumn][w];
     }
+    best = picked;
+    bestCost = cost;
+}
 
-    return primeImplicants;
+// Branches on the columns of the open row with the fewest of them. The
+// bound adds, for a set of open rows no two of which share a column, the
+// cheapest column of each: every cover pays at least that much more.
+void CoverSearch::search(const std::vector<uint64_t>& open, int cost, std::vector<uint32_t>& picked) {
+    if (std::chrono::steady_clock::now() > deadline) return;
+    if (!std::any_of(open.begin(), open.end(), [](uint64_t w) { return w != 0; })) {
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = picked;
+        }
+        return;
+    }
+
+    int bound = cost;
+    std::vector<uint64_t> blocked(rowWords, 0);
+    size_t branchRow = 0;
+    size_t fewest = SIZE_MAX;
+    forEach(open, [&](size_t row) {
+        size_t count = 0;
+        int cheapest = INT32_MAX;
+        forEach(rowColumns[row], [&](size_t column) {
+            ++count;
+            cheapest = std::min(cheapest, costs[column]);
+        });
+        if (count < fewest) {
+            fewest = count;
+            branchRow = row;
+        }
+        if (test(blocked, row)) return;
+        bound += cheapest;
+        forEach(rowColumns[row], [&](size_t column) {
+            for (size_t w = 0; w < rowWords; ++w) blocked[w] |= columns[column][w];
+        });
+    });
+    if (bound >= bestCost) return;
+
+    std::vector<std::pair<int, uint32_t>> branches;
+    forEach(rowColumns[branchRow], [&](size_t column) {
+        int gain = 0;
+        for (size_t w = 0; w < rowWords; ++w) gain += __builtin_popcountll(columns[column][w] & open[w]);
+        branches.push_back({-gain, static_cast<uint32_t>(column)});
+    });
+    std::sort(branches.begin(), branches.end());
+
+    std::vector<uint64_t> next(rowWords);
+    for (const auto& branch : branches) {
+        for (size_t w = 0; w < rowWords; ++w) next[w] = open[w] & ~columns[branch.second][w];
+        picked.push_back(branch.second);
+        search(next, cost + costs[branch.second], picked);
+        picked.pop_back();
+    }
+}
+
+std::vector<uint32_t> CoverSearch::solve() {
+    // Pairwise dominance checks are quadratic; skip them on cores where
+    // they alone would eat the time budget.
+    const bool dominance = columns.size() * columns.size() * rowWords + rowColumns.size() * rowColumns.size() * columnWords < (size_t(1) << 28);
+    while (reduceOnce(dominance) && std::chrono::steady_clock::now() < deadline) {
+    }
+
+    greedy();
+    std::vector<uint32_t> picked;
+    search(uncovered, 0, picked);
+
+    std::vector<uint32_t> cover = selected;
+    cover.insert(cover.end(), best.begin(), best.end());
+    return cover;
+}
+
+}  // namespace
+
+std::vector<ExpressionSimplifier::Implicant> ExpressionSimplifier::selectCover(const std::vector<Implicant>& primeImplicants,
+                                                                               const std::vector<int>& minterms, int numVars) const {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(COVER_TIME_BUDGET_MS);
+
+    // Minterms covered by each prime, found by enumerating the sub-masks
+    // of its eliminated variables.
+    std::vector<int> rowOf(size_t(1) << numVars, -1);
+    for (size_t r = 0; r < minterms.size(); ++r) rowOf[minterms[r]] = static_cast<int>(r);
+    auto forEachMinterm = [&](const Implicant& prime, auto visit) {
+        for (uint32_t sub = prime.mask;; sub = (sub - 1) & prime.mask) {
+            visit(rowOf[prime.value | sub]);
+            if (sub == 0) break;
+        }
+    };
+
+    // Primes that alone cover some minterm are in every cover.
+    std::vector<uint32_t> coverCount(minterms.size(), 0);
+    for (const Implicant& prime : primeImplicants) forEachMinterm(prime, [&](int row) { ++coverCount[row]; });
+    std::vector<uint8_t> chosen(primeImplicants.size(), 0);
+    std::vector<uint8_t> covered(minterms.size(), 0);
+    for (size_t p = 0; p < primeImplicants.size(); ++p) {
+        bool essential = false;
+        forEachMinterm(primeImplicants[p], [&](int row) { essential = essential || coverCount[row] == 1; });
+        if (!essential) continue;
+        chosen[p] = 1;
+        forEachMinterm(primeImplicants[p], [&](int row) { covered[row] = 1; });
+    }
+
+    // What is left is solved exactly on its own covering matrix. A term
+    // costs more than all the literals it can hold, so covers are compared
+    // mostly by term count, then by literals.
+    std::vector<int> coreRow(minterms.size(), -1);
+    size_t coreRows = 0;
+    for (size_t r = 0; r < minterms.size(); ++r) {
+        if (!covered[r]) coreRow[r] = static_cast<int>(coreRows++);
+    }
+    if (coreRows > 0) {
+        std::vector<uint32_t> corePrimes;
+        std::vector<std::vector<uint32_t>> coverage;
+        std::vector<int> costs;
+        for (size_t p = 0; p < primeImplicants.size(); ++p) {
+            if (chosen[p]) continue;
+            std::vector<uint32_t> rows;
+            forEachMinterm(primeImplicants[p], [&](int row) {
+                if (coreRow[row] >= 0) rows.push_back(static_cast<uint32_t>(coreRow[row]));
+            });
+            if (rows.empty()) continue;
+            corePrimes.push_back(static_cast<uint32_t>(p));
+            coverage.push_back(std::move(rows));
+            costs.push_back(2 * numVars + 1 - __builtin_popcount(primeImplicants[p].mask));
+        }
+        CoverSearch search(coverage, costs, coreRows, deadline);
+        for (uint32_t column : search.solve()) chosen[corePrimes[column]] = 1;
+    }
+
+    // Fewest literals first, then by variable: positive, negated, absent.
+    std::vector<Implicant> cover;
+    for (size_t p = 0; p < primeImplicants.size(); ++p) {
+        if (chosen[p]) cover.push_back(primeImplicants[p]);
+    }
+    auto orderKey = [numVars](const Implicant& term) {
+        uint64_t key = static_cast<uint64_t>(numVars - __builtin_popcount(term.mask));
+        for (int i = 0; i < numVars; ++i) {
+            const uint32_t bit = 1u << (numVars - 1 - i);
+            key = key * 3 + ((term.mask & bit) ? 2 : (term.value & bit) ? 0 : 1);
+        }
+        return key;
+    };
+    std::sort(cover.begin(), cover.end(), [&](const Implicant& a, const Implicant& b) { return orderKey(a) < orderKey(b); });
+    return cover;
 }
 
-std::string ExpressionSimplifier::generateSimplifiedExpression(const std::vector<Implicant>& primeImplicants, const std::vector<int>& minterms,
-                                                               int numVars, const std::string& expression) const {
+std::string ExpressionSimplifier::generateSimplifiedExpression(const std::vector<Implicant>& primeImplicants, int numVars,
+                                                               const std::string& expression) const {
     if (primeImplicants.empty()) {
         return "0";
     }
 
-    std::set<char> variables = getVariables(expression);
-    std::vector<char> varList(variables.begin(), variables.end());
-    std::sort(varList.begin(), varList.end());
+    std::vector<std::string> varList = getVariables(expression);
 
     std::vector<std::string> terms;
 
     for (const auto& imp : primeImplicants) {
         std::string term = "";
 
-        for (int i = 0; i < numVars && i < static_cast<int>(imp.pattern.length()); i++) {
-            if (imp.pattern[i] != '-') {
-                if (!term.empty()) {
-                    term += ".";
-                }
+        for (int i = 0; i < numVars && i < static_cast<int>(varList.size()); i++) {
+            const uint32_t bit = 1u << (numVars - 1 - i);
+            if (imp.mask & bit) continue;
 
-                if (i < static_cast<int>(varList.size())) {
-                    if (imp.pattern[i] == '0') {
-                        term += "~" + std::string(1, varList[i]);
-                    } else {
-                        term += std::string(1, varList[i]);
-                    }
-                }
+            if (!term.empty()) {
+                term += ".";
             }
+            term += (imp.value & bit) ? varList[i] : "~" + varList[i];
         }
 
         if (term.empty()) {
@@ -329,51 +651,112 @@ std::string ExpressionSimplifier::generateSimplifiedExpression(const std::vector
     return result;
 }
 
-bool ExpressionSimplifier::canCombine(const std::string& pattern1, const std::string& pattern2) const {
-    if (pattern1.length() != pattern2.length()) {
-        return false;
+std::string ExpressionSimplifier::minimizeHeuristic(const std::string& expression, int numVars) const {
+    const std::vector<std::string> varList = getVariables(expression);
+    EspressoMinimizer minimizer(numVars);
+    EspressoMinimizer::Cover onSet;
+    if (!buildCover(compileExpression(expression, varList), minimizer, onSet)) {
+        return expression;
     }
 
-    int differences = 0;
-    for (size_t i = 0; i < pattern1.length(); i++) {
-        if (pattern1[i] != pattern2[i]) {
-            differences++;
-            if (differences > 1) {
-                return false;
-            }
-        }
+    const EspressoMinimizer::Cover cover = minimizer.minimize(onSet);
+    if (cover.empty()) {
+        return "0";
     }
-
-    return differences == 1;
+    if (minimizer.isUniverse(cover[0])) {
+        return "1";
+    }
+    return generateCoverExpression(cover, varList);
 }
 
-std::string ExpressionSimplifier::combinePatterns(const std::string& pattern1, const std::string& pattern2) const {
-    std::string result = "";
-
-    for (size_t i = 0; i < pattern1.length(); i++) {
-        if (pattern1[i] == pattern2[i]) {
-            result += pattern1[i];
-        } else {
-            result += '-';
+// Runs the postfix program on covers instead of bits. Gives up, returning
+// false, when an intermediate cover grows past EspressoMinimizer::MAX_CUBES.
+bool ExpressionSimplifier::buildCover(const CompiledExpression& compiled, const EspressoMinimizer& minimizer,
+                                      EspressoMinimizer::Cover& cover) const {
+    using Op = CompiledExpression::Op;
+    cover.clear();
+    if (!compiled.valid) return true;
+
+    std::vector<EspressoMinimizer::Cover> stack;
+    EspressoMinimizer::Cover a;
+    EspressoMinimizer::Cover b;
+    for (const CompiledExpression::Instruction& instruction : compiled.code) {
+        switch (instruction.op) {
+            case Op::Constant:
+                stack.emplace_back();
+                if (instruction.operand) stack.back().push_back(minimizer.universe());
+                break;
+            case Op::Variable:
+                stack.push_back({minimizer.literal(static_cast<int>(instruction.operand), true)});
+                break;
+            case Op::Not:
+                if (!minimizer.complement(stack.back(), a)) return false;
+                stack.back() = std::move(a);
+                break;
+            case Op::And:
+            case Op::Or:
+            case Op::Xor: {
+                EspressoMinimizer::Cover right = std::move(stack.back());
+                stack.pop_back();
+                EspressoMinimizer::Cover& left = stack.back();
+                EspressoMinimizer::Cover result;
+                if (instruction.op == Op::And) {
+                    if (!minimizer.intersect(left, right, result)) return false;
+                } else if (instruction.op == Op::Or) {
+                    if (!minimizer.unite(left, right, result)) return false;
+                } else {
+                    // a ^ b = a.~b + ~a.b
+                    EspressoMinimizer::Cover notLeft;
+                    EspressoMinimizer::Cover notRight;
+                    if (!minimizer.complement(left, notLeft) || !minimizer.complement(right, notRight)) return false;
+                    if (!minimizer.intersect(left, notRight, a) || !minimizer.intersect(notLeft, right, b)) return false;
+                    if (!minimizer.unite(a, b, result)) return false;
+                }
+                left = std::move(result);
+                break;
+            }
         }
     }
-
-    return result;
+    cover = std::move(stack.back());
+    return true;
 }
 
-int ExpressionSimplifier::countOnes(const std::string& binary) const {
-    int count = 0;
-    for (char c : binary) {
-        if (c == '1') {
-            count++;
+// Same term order as selectCover(): fewest literals first, then by variable:
+// positive, negated, absent.
+std::string ExpressionSimplifier::generateCoverExpression(const EspressoMinimizer::Cover& cover, const std::vector<std::string>& variables) const {
+    const int numVars = static_cast<int>(variables.size());
+    auto rank = [numVars](const EspressoMinimizer::Cube& cube, int i) {
+        const uint64_t bit = 1ULL << (numVars - 1 - i);
+        return (cube.zeros & bit) && (cube.ones & bit) ? 2 : (cube.ones & bit) ? 0 : 1;
+    };
+    EspressoMinimizer::Cover terms = cover;
+    std::sort(terms.begin(), terms.end(), [&](const EspressoMinimizer::Cube& a, const EspressoMinimizer::Cube& b) {
+        const int la = EspressoMinimizer::literalCount(a);
+        const int lb = EspressoMinimizer::literalCount(b);
+        if (la != lb) return la < lb;
+        for (int i = 0; i < numVars; ++i) {
+            if (rank(a, i) != rank(b, i)) return rank(a, i) < rank(b, i);
         }
+        return false;
+    });
+
+    std::string result;
+    for (const EspressoMinimizer::Cube& cube : terms) {
+        std::string term;
+        for (int i = 0; i < numVars; ++i) {
+            const int r = rank(cube, i);
+            if (r == 2) continue;
+            if (!term.empty()) term += ".";
+            term += r == 0 ? variables[i] : "~" + variables[i];
+        }
+        if (!result.empty()) result += " + ";
+        result += term.empty() ? "1" : term;
     }
-    return count;
+    return result;
 }
 
 int ExpressionSimplifier::getVariableCount(const std::string& expression) const {
-    std::set<char> variables = getVariables(expression);
-    return static_cast<int>(variables.size());
+    return static_cast<int>(getVariables(expression).size());
 }
 
 std::string ExpressionSimplifier::convertToStandardForm(const std::string& expression) const {
@@ -384,124 +767,198 @@ std::string ExpressionSimplifier::convertToStandardForm(const std::string& expre
     return result;
 }
 
-bool ExpressionSimplifier::evaluateExpression(const std::string& expression, const std::map<char, bool>& values) const {
-    std::string expr = expression;
-
-    for (const auto& pair : values) {
-        std::string var(1, pair.first);
-        std::string val = pair.second ? "1" : "0";
-
-        size_t pos = 0;
-        while ((pos = expr.find(var, pos)) != std::string::npos) {
-            expr.replace(pos, var.length(), val);
-            pos += val.length();
-        }
-    }
-
-    std::stack<bool> operands;
-    std::stack<char> operators;
-
-    for (size_t i = 0; i < expr.length(); i++) {
-        char c = expr[i];
-
-        if (c == '1') {
-            operands.push(true);
-        } else if (c == '0') {
-            operands.push(false);
-        } else if (c == '~') {
-            if (i + 1 < expr.length()) {
-                i++;
-                if (expr[i] == '1') {
-                    operands.push(false);
-                } else if (expr[i] == '0') {
-                    operands.push(true);
-                } else if (expr[i] == '(') {
-                    int parenCount = 1;
-                    size_t start = i + 1;
-                    i++;
-                    while (i < expr.length() && parenCount > 0) {
-                        if (expr[i] == '(')
-                            parenCount++;
-                        else if (expr[i] == ')')
-                            parenCount--;
-                        i++;
-                    }
-                    std::string subExpr = expr.substr(start, i - start - 1);
-                    bool subResult = evaluateExpression(subExpr, values);
-                    operands.push(!subResult);
-                    i--;
-                }
-            }
-        } else if (c == '.' || c == '+' || c == '^') {
-            while (!operators.empty() && ((c == '+' && (operators.top() == '.' || operators.top() == '^')) || (c == '^' && operators.top() == '.'))) {
-                char op = operators.top();
-                operators.pop();
-
-                if (operands.size() >= 2) {
-                    bool b = operands.top();
-                    operands.pop();
-                    bool a = operands.top();
-                    operands.pop();
-
-                    if (op == '.') {
-                        operands.push(a && b);
-                    } else if (op == '+') {
-                        operands.push(a || b);
-                    } else if (op == '^') {
-                        operands.push(a != b);
-                    }
-                }
+bool ExpressionSimplifier::evaluateExpression(const std::string& expression, const std::map<std::string, bool>& values) const {
+    const std::vector<std::string> variables = getVariables(expression);
+    if (variables.size() > 64) return false;
+
+    uint64_t row = 0;
+    for (const std::string& variable : variables) {
+        auto it = values.find(variable);
+        row = (row << 1) | (it != values.end() && it->second);
+    }
+    return compileExpression(expression, variables).evaluate(row);
+}
+
+ExpressionSimplifier::CompiledExpression ExpressionSimplifier::compileExpression(const std::string& expression,
+                                                                                 const std::vector<std::string>& variables) const {
+    CompiledExpression compiled;
+    if (variables.size() > 64) return compiled;
+
+    std::map<std::string, uint32_t> bits;
+    for (size_t j = 0; j < variables.size(); ++j) bits[variables[j]] = static_cast<uint32_t>(variables.size() - 1 - j);
+
+    // Shunting-yard: operands are emitted as they are read and operators
+    // once nothing of higher precedence is left above them. depth tracks
+    // the evaluation stack so malformed input is caught here, not per row.
+    std::vector<char> operators;
+    size_t depth = 0;
+    bool valid = true;
+    auto precedence = [](char op) { return op == '.' ? 3 : op == '^' ? 2 : op == '+' ? 1 : 0; };
+    auto emit = [&](CompiledExpression::Op op, uint32_t operand) {
+        if (op == CompiledExpression::Op::Constant || op == CompiledExpression::Op::Variable) {
+            ++depth;
+        } else if (op == CompiledExpression::Op::Not) {
+            valid = valid && depth >= 1;
+        } else if (depth >= 2) {
+            --depth;
+        } else {
+            valid = false;
+        }
+        compiled.depth = std::max(compiled.depth, depth);
+        compiled.code.push_back({op, operand});
+    };
+    auto emitOperator = [&](char op) {
+        emit(op == '.' ? CompiledExpression::Op::And : op == '^' ? CompiledExpression::Op::Xor : CompiledExpression::Op::Or, 0);
+    };
+    auto applyNots = [&] {
+        while (!operators.empty() && operators.back() == '~') {
+            emit(CompiledExpression::Op::Not, 0);
+            operators.pop_back();
+        }
+    };
+
+    for (size_t i = 0; i < expression.size() && valid;) {
+        const char c = expression[i];
+        if (std::isupper(static_cast<unsigned char>(c))) {
+            size_t end = i;
+            while (end < expression.size() && std::isupper(static_cast<unsigned char>(expression[end]))) ++end;
+            auto it = bits.find(expression.substr(i, end - i));
+            if (it != bits.end()) {
+                emit(CompiledExpression::Op::Variable, it->second);
+            } else {
+                emit(CompiledExpression::Op::Constant, 0);
             }
-            operators.push(c);
-        } else if (c == '(') {
-            operators.push(c);
+            applyNots();
+            i = end;
+            continue;
+        }
+
+        if (c == '0' || c == '1') {
+            emit(CompiledExpression::Op::Constant, c == '1');
+            applyNots();
+        } else if (c == '~' || c == '(') {
+            operators.push_back(c);
         } else if (c == ')') {
-            while (!operators.empty() && operators.top() != '(') {
-                char op = operators.top();
-                operators.pop();
-
-                if (operands.size() >= 2) {
-                    bool b = operands.top();
-                    operands.pop();
-                    bool a = operands.top();
-                    operands.pop();
-
-                    if (op == '.') {
-                        operands.push(a && b);
-                    } else if (op == '+') {
-                        operands.push(a || b);
-                    } else if (op == '^') {
-                        operands.push(a != b);
-                    }
-                }
+            while (!operators.empty() && operators.back() != '(') {
+                emitOperator(operators.back());
+                operators.pop_back();
+            }
+            if (operators.empty()) {
+                valid = false;
+                break;
             }
-            if (!operators.empty()) {
-                operators.pop();
+            operators.pop_back();
+            applyNots();
+        } else if (precedence(c) > 0) {
+            while (!operators.empty() && precedence(operators.back()) >= precedence(c)) {
+                emitOperator(operators.back());
+                operators.pop_back();
             }
+            operators.push_back(c);
         }
+        ++i;
     }
 
-    while (!operators.empty()) {
-        char op = operators.top();
-        operators.pop();
+    while (valid && !operators.empty()) {
+        if (precedence(operators.back()) == 0) {
+            valid = false;
+            break;
+        }
+        emitOperator(operators.back());
+        operators.pop_back();
+    }
 
-        if (operands.size() >= 2) {
-            bool b = operands.top();
-            operands.pop();
-            bool a = operands.top();
-            operands.pop();
+    compiled.valid = valid && depth == 1;
+    if (!compiled.valid) compiled.code.clear();
+    return compiled;
+}
 
-            if (op == '.') {
-                operands.push(a && b);
-            } else if (op == '+') {
-                operands.push(a || b);
-            } else if (op == '^') {
-                operands.push(a != b);
-            }
+bool ExpressionSimplifier::CompiledExpression::evaluate(uint64_t row) const {
+    if (!valid) return false;
+
+    uint8_t local[64] = {};
+    std::vector<uint8_t> spill;
+    uint8_t* stack = local;
+    if (depth > 64) {
+        spill.resize(depth);
+        stack = spill.data();
+    }
+
+    size_t top = 0;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case Op::Constant:
+                stack[top++] = static_cast<uint8_t>(instruction.operand);
+                break;
+            case Op::Variable:
+                stack[top++] = (row >> instruction.operand) & 1;
+                break;
+            case Op::Not:
+                stack[top - 1] ^= 1;
+                break;
+            case Op::And:
+                --top;
+                stack[top - 1] &= stack[top];
+                break;
+            case Op::Or:
+                --top;
+                stack[top - 1] |= stack[top];
+                break;
+            case Op::Xor:
+                --top;
+                stack[top - 1] ^= stack[top];
+                break;
         }
     }
+    return stack[0];
+}
 
-    return operands.empty() ? false : operands.top();
+uint64_t ExpressionSimplifier::CompiledExpression::evaluateWord(uint64_t firstRow) const {
+    // Bit k of PROJECTIONS[b] is bit b of k; higher row bits are the same
+    // for all 64 rows of the word.
+    static constexpr uint64_t PROJECTIONS[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+                                                0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+    if (!valid) return 0;
+
+    uint64_t local[64] = {};
+    std::vector<uint64_t> spill;
+    uint64_t* stack = local;
+    if (depth > 64) {
+        spill.resize(depth);
+        stack = spill.data();
+    }
+
+    size_t top = 0;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case Op::Constant:
+                stack[top++] = instruction.operand ? ~0ULL : 0;
+                break;
+            case Op::Variable:
+                if (instruction.operand < 6) {
+                    stack[top++] = PROJECTIONS[instruction.operand];
+                } else {
+                    stack[top++] = ((firstRow >> instruction.operand) & 1) ? ~0ULL : 0;
+                }
+                break;
+            case Op::Not:
+                stack[top - 1] = ~stack[top - 1];
+                break;
+            case Op::And:
+                --top;
+                stack[top - 1] &= stack[top];
+                break;
+            case Op::Or:
+                --top;
+                stack[top - 1] |= stack[top];
+                break;
+            case Op::Xor:
+                --top;
+                stack[top - 1] ^= stack[top];
+                break;
+        }
+    }
+    return stack[0];
 }
 
 bool ExpressionSimplifier::isValidExpression(const std::string& expression) const {
@@ -518,14 +975,27 @@ bool ExpressionSimplifier::isValidExpression(const std::string& expression) cons
     return true;
 }
 
-std::set<char> ExpressionSimplifier::getVariables(const std::string& expression) const {
-    std::set<char> variables;
+std::vector<std::string> ExpressionSimplifier::getVariables(const std::string& expression) const {
+    return getVariables(std::vector<std::string>{expression});
+}
 
-    for (char c : expression) {
-        if (std::isalpha(c) && std::isupper(c)) {
-            variables.insert(c);
+std::vector<std::string> ExpressionSimplifier::getVariables(const std::vector<std::string>& expressions) const {
+    std::set<std::string> names;
+
+    for (const std::string& expression : expressions) {
+        for (size_t i = 0; i < expression.size();) {
+            if (!std::isupper(static_cast<unsigned char>(expression[i]))) {
+                ++i;
+                continue;
+            }
+            size_t end = i;
+            while (end < expression.size() && std::isupper(static_cast<unsigned char>(expression[end]))) ++end;
+            names.insert(expression.substr(i, end - i));
+            i = end;
         }
     }
 
+    std::vector<std::string> variables(names.begin(), names.end());
+    std::stable_sort(variables.begin(), variables.end(), [](const std::string& a, const std::string& b) { return a.size() < b.size(); });
     return variables;
 }
@@ -1,53 +1,83 @@
 #pragma once
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "EspressoMinimizer.hpp"
+
+// Exact runs Quine-McCluskey on the full truth table; Heuristic runs
+// EspressoMinimizer on cubes; Auto picks Exact up to
+// ExpressionSimplifier::MAX_SIMPLIFY_VARIABLES and Heuristic above.
+enum class MinimizationEngine { Auto, Exact, Heuristic };
+
 class ExpressionSimplifier {
-   private:
-    struct MinTerm {
-        int value;
-        std::vector<int> variables;
-        std::string binary;
-
-        MinTerm(int v, int numVars) : value(v) {
-            binary = "";
-            for (int i = numVars - 1; i >= 0; i--) {
-                binary += ((v >> i) & 1) ? '1' : '0';
-            }
-
-            for (int i = 0; i < numVars; i++) {
-                variables.push_back((v >> (numVars - 1 - i)) & 1);
-            }
-        }
+   public:
+    // An expression parsed once into a postfix program over variable
+    // indices. Variable j of the list it was compiled against reads bit
+    // (n - 1 - j) of the row, so row r of a truth table is evaluate(r).
+    struct CompiledExpression {
+        enum class Op : uint8_t { Constant, Variable, Not, And, Or, Xor };
+        struct Instruction {
+            Op op;
+            uint32_t operand;
+        };
+
+        std::vector<Instruction> code;
+        size_t depth = 0;
+        // False for unbalanced input; evaluate() then returns false.
+        bool valid = false;
+
+        bool evaluate(uint64_t row) const;
+        // Rows firstRow .. firstRow + 63 at once, row firstRow + k in bit k;
+        // firstRow must be a multiple of 64.
+        uint64_t evaluateWord(uint64_t firstRow) const;
     };
 
+   private:
+    // A cube over the row bits: variables under mask are eliminated, the
+    // others must equal the matching bits of value (zero under mask).
     struct Implicant {
-        std::vector<int> terms;
-        std::string pattern;
-        bool used;
+        uint32_t value;
+        uint32_t mask;
 
-        Implicant(const std::vector<int>& t, const std::string& p) : terms(t), pattern(p), used(false) {}
+        bool covers(uint32_t minterm) const { return (minterm & ~mask) == value; }
     };
 
     // Helper methods
-    std::vector<std::vector<int>> generateTruthTable(const std::string& expression, int numVars) const;
-    std::vector<int> extractMinterms(const std::vector<std::vector<int>>& truthTable) const;
-    std::string quineMcCluskey(const std::vector<int>& minterms, int numVars, const std::string& expression) const;
-    std::vector<std::vector<Implicant>> groupByOnes(const std::vector<int>& minterms, int numVars) const;
-    std::vector<Implicant> findPrimeImplicants(const std::vector<int>& minterms, int numVars) const;
-    std::string generateSimplifiedExpression(const std::vector<Implicant>& primeImplicants, const std::vector<int>& minterms, int numVars,
-                                             const std::string& expression) const;
-    bool canCombine(const std::string& pattern1, const std::string& pattern2) const;
-    std::string combinePatterns(const std::string& pattern1, const std::string& pattern2) const;
-    int countOnes(const std::string& binary) const;
+    // Packed truth table: bit r of word r / 64 is row r.
+    std::vector<uint64_t> generateTruthTable(const CompiledExpression& compiled, int numVars) const;
+    std::vector<int> extractMinterms(const std::vector<uint64_t>& truthTable) const;
+    std::string quineMcCluskey(const std::vector<uint64_t>& truthTable, const std::vector<int>& minterms, int numVars,
+                               const std::string& expression) const;
+    std::vector<Implicant> findPrimeImplicants(const std::vector<uint64_t>& truthTable, int numVars) const;
+    void collectPrimeImplicants(const std::vector<uint64_t>& cubes, uint32_t mask, int numVars, std::vector<Implicant>& primes) const;
+    std::vector<Implicant> selectCover(const std::vector<Implicant>& primeImplicants, const std::vector<int>& minterms, int numVars) const;
+    std::string generateSimplifiedExpression(const std::vector<Implicant>& primeImplicants, int numVars, const std::string& expression) const;
+    std::string minimizeHeuristic(const std::string& expression, int numVars) const;
+    bool buildCover(const CompiledExpression& compiled, const EspressoMinimizer& minimizer, EspressoMinimizer::Cover& cover) const;
+    std::string generateCoverExpression(const EspressoMinimizer::Cover& cover, const std::vector<std::string>& variables) const;
     int getVariableCount(const std::string& expression) const;
     std::string convertToStandardForm(const std::string& expression) const;
 
+    MinimizationEngine engine = MinimizationEngine::Auto;
+
    public:
     ExpressionSimplifier() = default;
 
+    // Exact minimization and truth tables enumerate every row, so they are
+    // limited to this many variables; beyond it Exact returns expressions
+    // unsimplified and truth tables are refused. Heuristic takes up to
+    // EspressoMinimizer::MAX_VARIABLES.
+    static constexpr int MAX_SIMPLIFY_VARIABLES = 16;
+    static constexpr int MAX_TABLE_VARIABLES = 16;
+    // Exact cover search stops after this long and keeps the best cover found.
+    static constexpr int COVER_TIME_BUDGET_MS = 50;
+
+    void setMinimizationEngine(MinimizationEngine value) { engine = value; }
+    MinimizationEngine getMinimizationEngine() const { return engine; }
+
     // Main simplification method
     std::string simplifyExpression(const std::string& expression) const;
 
@@ -60,9 +90,17 @@ class ExpressionSimplifier {
     // Validate expression format
     bool isValidExpression(const std::string& expression) const;
 
-    // Get variable names from expression
-    std::set<char> getVariables(const std::string& expression) const;
+    // Get variable names from expression: runs of capital letters, ordered
+    // like input labels (A..Z, AA, AB, ...)
+    std::vector<std::string> getVariables(const std::string& expression) const;
+    std::vector<std::string> getVariables(const std::vector<std::string>& expressions) const;
+
+    // Evaluate expression with given variable values; missing variables read 0
+    bool evaluateExpression(const std::string& expression, const std::map<std::string, bool>& values) const;
 
-    // Evaluate expression with given variable values
-    bool evaluateExpression(const std::string& expression, const std::map<char, bool>& values) const;
+    // Parses an expression against a variable list (at most 64 names, e.g.
+    // from getVariables). Names not in the list read 0. '.' binds tighter
+    // than '^', which binds tighter than '+'; '~' applies to the operand or
+    // bracket that follows it.
+    CompiledExpression compileExpression(const std::string& expression, const std::vector<std::string>& variables) const;
 };
@@ -1,5 +1,9 @@
 #include "Gate.hpp"
 
+#include <algorithm>
+
+#include "Netlist.hpp"
+
 Gate::Gate(GateType type, sf::Vector2f position, int persistentLabel) : type(type), position(position), persistentLabel(persistentLabel) {
     shape.setSize({100.f, 70.f});
     shape.setPosition(position);
@@ -9,12 +13,43 @@ Gate::Gate(GateType type, sf::Vector2f position, int persistentLabel) : type(typ
     switch (type) {
         case GateType::INPUT:
         case GateType::OUTPUT:
+        case GateType::CLOCK:
             shape.setFillColor(sf::Color(128, 128, 128));
             break;
         default:
             shape.setFillColor(sf::Color(200, 200, 200));
             break;
     }
+
+    switch (type) {
+        case GateType::INPUT:
+        case GateType::CLOCK:
+            inputCount = 0;
+            break;
+        case GateType::NOT:
+        case GateType::OUTPUT:
+            inputCount = 1;
+            break;
+        default:
+            inputCount = 2;
+            break;
+    }
+}
+
+Gate::Gate(const std::string &moduleName, sf::Vector2f position, int inputCount, int outputCount)
+    : type(GateType::MODULE), position(position), inputCount(inputCount), outputCount(outputCount), moduleName(moduleName) {
+    const int pins = std::max(inputCount, outputCount);
+    shape.setSize({100.f, std::max(70.f, 40.f + (pins > 2 ? 20.f : 30.f) * (pins - 1))});
+    shape.setPosition(position);
+    shape.setOutlineThickness(2.f);
+    shape.setOutlineColor(sf::Color::Black);
+    shape.setFillColor(sf::Color(170, 200, 230));
+}
+
+void Gate::setInputPinCount(int count) {
+    if (!isMultiInput(type)) return;
+    inputCount = std::clamp(count, 2, MAX_GATE_INPUTS);
+    shape.setSize({100.f, std::max(70.f, getInputPinPosition(inputCount - 1).y - position.y + 20.f)});
 }
 
 void Gate::setFont(const sf::Font &font) {
@@ -22,9 +57,17 @@ void Gate::setFont(const sf::Font &font) {
     currentFont = &font;
 }
 
-void Gate::draw(sf::RenderWindow &window, size_t gateIndex, const std::vector<Gate> &gates, int selectedPin) const {
+void Gate::draw(sf::RenderWindow &window, uint64_t outputStates, int selectedPin) const {
+    const bool state = outputStates & 1;
     sf::RectangleShape gateShape = shape;
+    if (type == GateType::INPUT || type == GateType::OUTPUT || type == GateType::CLOCK) {
+        gateShape.setFillColor(state ? sf::Color::Red : sf::Color(128, 128, 128));
+    }
 
+    if (oscillating) {
+        gateShape.setOutlineThickness(2.f * 2);
+        gateShape.setOutlineColor(sf::Color::Red);
+    }
     if (selected) {
         gateShape.setOutlineThickness(2.f * 2);
         gateShape.setOutlineColor(sf::Color::Yellow);
@@ -32,24 +75,23 @@ void Gate::draw(sf::RenderWindow &window, size_t gateIndex, const std::vector<Ga
 
     window.draw(gateShape);
 
-    drawGateLabel(window, gateIndex, gates);
+    drawGateLabel(window);
 
     sf::CircleShape pin(6.f);
     pin.setOutlineThickness(1.f);
     pin.setOutlineColor(sf::Color::Black);
 
-    if (type != GateType::OUTPUT) {
-        pin.setFillColor(state ? sf::Color::Red : sf::Color::White);
-        sf::Vector2f outPinPos = getOutputPinPosition();
+    for (int k = 0; k < getOutputPinCount(); ++k) {
+        pin.setFillColor((outputStates >> k) & 1 ? sf::Color::Red : sf::Color::White);
+        sf::Vector2f outPinPos = getOutputPinPosition(k);
         pin.setPosition(outPinPos - sf::Vector2f{6.f, 6.f});
         window.draw(pin);
-        if (selectedPin == -1) {
+        if (selectedPin == -1 - k) {
             drawPinHighlight(window, outPinPos);
         }
     }
 
-    if (type != GateType::INPUT) {
-        int inputCount = (type == GateType::NOT || type == GateType::OUTPUT) ? 1 : 2;
+    if (inputCount > 0) {
         pin.setFillColor(sf::Color::White);
 
         for (int i = 0; i < inputCount; ++i) {
@@ -63,61 +105,30 @@ void Gate::draw(sf::RenderWindow &window, size_t gateIndex, const std::vector<Ga
     }
 }
 
-bool Gate::evaluate(const std::vector<bool> &inputs) const {
-    try {
-        switch (type) {
-            case GateType::AND:
-                return inputs.size() >= 2 && (inputs.at(0) && inputs.at(1));
-            case GateType::OR:
-                return inputs.size() >= 2 && (inputs.at(0) || inputs.at(1));
-            case GateType::NOT:
-                return inputs.size() >= 1 && !inputs.at(0);
-            case GateType::NAND:
-                return !(inputs.size() >= 2 && inputs.at(0) && inputs.at(1));
-            case GateType::NOR:
-                return !(inputs.size() >= 2 && (inputs.at(0) || inputs.at(1)));
-            case GateType::XOR:
-                return inputs.size() >= 2 && (inputs.at(0) != inputs.at(1));
-            case GateType::INPUT:
-                return state;
-            case GateType::OUTPUT:
-                return !inputs.empty() ? inputs.at(0) : false;
-            default:
-                return false;
-        }
-    } catch (const std::out_of_range &) {
-        return false;
-    }
-}
-
 sf::FloatRect Gate::getBounds() const { return shape.getGlobalBounds(); }
 
 sf::Vector2f Gate::getInputPinPosition(int pinIndex) const {
     if (type == GateType::NOT || type == GateType::OUTPUT) {
         return position + sf::Vector2f{0.f, 35.f};
     }
-    return position + sf::Vector2f{0.f, (pinIndex == 0) ? 20.f : 50.f};
+    const float spacing = inputCount > 2 ? 20.f : 30.f;
+    return position + sf::Vector2f{0.f, 20.f + spacing * pinIndex};
 }
 
-sf::Vector2f Gate::getOutputPinPosition() const { return position + sf::Vector2f{100.f, 35.f}; }
-
-void Gate::setState(bool state) {
-    this->state = state;
-    if (type == GateType::INPUT || type == GateType::OUTPUT) {
-        shape.setFillColor(state ? sf::Color::Red : sf::Color(128, 128, 128));
-    }
+sf::Vector2f Gate::getOutputPinPosition(int index) const {
+    if (outputCount == 1) return position + sf::Vector2f{100.f, shape.getSize().y / 2.f};
+    const float spacing = outputCount > 2 ? 20.f : 30.f;
+    return position + sf::Vector2f{100.f, 20.f + spacing * index};
 }
 
-bool Gate::getState() const { return state; }
-
 GateType Gate::getType() const { return type; }
 
-std::string Gate::getGateTypeString(size_t gateIndex, const std::vector<Gate> &gates) const {
+std::string Gate::getGateTypeString() const {
     switch (type) {
         case GateType::INPUT:
-            return persistentLabel >= 0 ? std::string(1, 'A' + persistentLabel) : "IN";
+            return persistentLabel >= 0 ? Netlist::getInputLabelName(persistentLabel) : "IN";
         case GateType::OUTPUT:
-            return persistentLabel >= 0 ? "Y" + std::to_string(persistentLabel + 1) : "OUT";
+            return persistentLabel >= 0 ? Netlist::getOutputLabelName(persistentLabel) : "OUT";
         case GateType::AND:
             return "AND";
         case GateType::OR:
@@ -130,18 +141,26 @@ std::string Gate::getGateTypeString(size_t gateIndex, const std::vector<Gate> &g
             return "NOR";
         case GateType::XOR:
             return "XOR";
+        case GateType::DFF:
+            return "DFF";
+        case GateType::LATCH:
+            return "LATCH";
+        case GateType::CLOCK:
+            return "CLK";
+        case GateType::MODULE:
+            return moduleName;
         default:
             return "?";
     }
 }
 
-void Gate::drawGateLabel(sf::RenderWindow &window, size_t gateIndex, const std::vector<Gate> &gates) const {
+void Gate::drawGateLabel(sf::RenderWindow &window) const {
     if (!currentFont) return;
-    sf::Text text(*currentFont, getGateTypeString(gateIndex, gates), 16);
+    sf::Text text(*currentFont, getGateTypeString(), 16);
     text.setFillColor(sf::Color::Black);
     sf::FloatRect textBounds = text.getLocalBounds();
     text.setOrigin({textBounds.size.x / 2.f, textBounds.size.y / 2.f});
-    text.setPosition(position + sf::Vector2f{50.f, 35.f});
+    text.setPosition(position + sf::Vector2f{50.f, shape.getSize().y / 2.f});
     window.draw(text);
 }
 
@@ -1,42 +1,53 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <string>
 #include <vector>
 
-enum class GateType { AND, OR, NOT, NAND, NOR, XOR, INPUT, OUTPUT };
+#include "GateType.hpp"
 
 class Gate {
    private:
     GateType type;
     sf::Vector2f position;
     sf::RectangleShape shape;
-    bool state = false;
     bool selected = false;
+    bool oscillating = false;
     int persistentLabel = -1;
+    int inputCount;
+    int outputCount = 1;
+    std::string moduleName;
 
     const sf::Font *currentFont = nullptr;
 
-    void drawGateLabel(sf::RenderWindow &window, size_t gateIndex, const std::vector<Gate> &gates) const;
+    void drawGateLabel(sf::RenderWindow &window) const;
     void drawPinHighlight(sf::RenderWindow &window, sf::Vector2f pinPos) const;
 
    public:
     Gate(GateType type, sf::Vector2f position, int persistentLabel);
+    // A MODULE instance: one body with the definition's pins, drawn with its name.
+    Gate(const std::string &moduleName, sf::Vector2f position, int inputCount, int outputCount);
     int getPersistentLabel() const { return persistentLabel; }
     void setPersistentLabel(int label) { persistentLabel = label; }
 
     void setFont(const sf::Font &font);
-    void draw(sf::RenderWindow &window, size_t gateIndex, const std::vector<Gate> &gates, int selectedPin = -100) const;
-    bool evaluate(const std::vector<bool> &inputs) const;
-
+    // Render data only; the logic values live in Circuit and are passed in,
+    // bit k for output pin k. Output pin k is selected as pin -1 - k.
+    void draw(sf::RenderWindow &window, uint64_t outputStates, int selectedPin = -100) const;
+
+    int getInputPinCount() const { return inputCount; }
+    // Only AND, OR, NAND, NOR and XOR are resizable, from 2 to MAX_GATE_INPUTS
+    // pins; the body grows to fit them.
+    void setInputPinCount(int count);
     sf::Vector2f getInputPinPosition(int index) const;
-    sf::Vector2f getOutputPinPosition() const;
-
-    void setState(bool state);
+    int getOutputPinCount() const { return type == GateType::OUTPUT ? 0 : outputCount; }
+    sf::Vector2f getOutputPinPosition(int index = 0) const;
 
     sf::FloatRect getBounds() const;
-    bool getState() const;
     GateType getType() const;
-    std::string getGateTypeString(size_t gateIndex, const std::vector<Gate> &gates) const;
+    std::string getGateTypeString() const;
 
     void setSelected(bool isSelected);
+    // Marks a gate on a combinational loop that does not settle.
+    void setOscillating(bool isOscillating) { oscillating = isOscillating; }
 };
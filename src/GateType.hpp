@@ -0,0 +1,15 @@
+#pragma once
+
+// DFF samples pin 0 (D) on a rising edge of pin 1 (CLK); LATCH passes pin 0
+// (D) through while pin 1 (EN) is high. CLOCK is a free-running source.
+// MODULE is an instance of a ModuleLibrary definition and only appears in
+// netlists that have not been flattened yet.
+// AND, OR, NAND, NOR and XOR take every connected driver as an input, up
+// to MAX_GATE_INPUTS; XOR is odd parity.
+enum class GateType { AND, OR, NOT, NAND, NOR, XOR, INPUT, OUTPUT, DFF, LATCH, CLOCK, MODULE };
+
+constexpr int MAX_GATE_INPUTS = 64;
+
+inline bool isMultiInput(GateType type) {
+    return type == GateType::AND || type == GateType::OR || type == GateType::NAND || type == GateType::NOR || type == GateType::XOR;
+}
@@ -0,0 +1,158 @@
+#include "LevelParallelEvaluator.hpp"
+
+#include <algorithm>
+
+LevelParallelEvaluator::LevelParallelEvaluator(size_t threadCount, size_t threshold) : pool(threadCount), threshold(threshold) {}
+
+void LevelParallelEvaluator::prepare(const CompiledCircuit& compiledCircuit) {
+    circuit = &compiledCircuit;
+    parallel = false;
+    phases.clear();
+
+    const size_t gateCount = compiledCircuit.getGateCount();
+    const size_t threadCount = pool.getThreadCount();
+    if (threadCount < 2 || gateCount < threshold || gateCount >= NO_DRIVER) return;
+    if (!compiledCircuit.isAcyclic() || compiledCircuit.isStale()) return;
+
+    // Counting sort by level; within a level gates keep their index order.
+    int maxLevel = 0;
+    for (size_t gate = 0; gate < gateCount; ++gate) maxLevel = std::max(maxLevel, compiledCircuit.getLevel(gate));
+    std::vector<uint32_t> levelStart(maxLevel + 2, 0);
+    for (size_t gate = 0; gate < gateCount; ++gate) ++levelStart[compiledCircuit.getLevel(gate) + 1];
+    for (int level = 0; level <= maxLevel; ++level) levelStart[level + 1] += levelStart[level];
+
+    std::vector<uint32_t> positionOf(gateCount);
+    std::vector<uint32_t> next(levelStart.begin(), levelStart.end() - 1);
+    gateAt.resize(gateCount);
+    typeAt.resize(gateCount);
+    for (size_t gate = 0; gate < gateCount; ++gate) {
+        const uint32_t position = next[compiledCircuit.getLevel(gate)]++;
+        positionOf[gate] = position;
+        gateAt[position] = static_cast<uint32_t>(gate);
+        typeAt[position] = compiledCircuit.getType(gate);
+    }
+
+    driverOffsets.assign(1, 0);
+    drivers.clear();
+    for (uint32_t position = 0; position < gateCount; ++position) {
+        const size_t gate = gateAt[position];
+        if (typeAt[position] == GateType::LATCH) {
+            for (int pin = 0; pin < 2; ++pin) {
+                const size_t source = compiledCircuit.getPinSource(gate, pin);
+                drivers.push_back(source == SIZE_MAX ? NO_DRIVER : positionOf[source]);
+            }
+        } else if (!CompiledCircuit::isSource(typeAt[position])) {
+            for (size_t source : compiledCircuit.getFanIn(gate)) drivers.push_back(positionOf[source]);
+        }
+        driverOffsets.push_back(static_cast<uint32_t>(drivers.size()));
+    }
+
+    // A level is split only if every worker gets a couple of cache lines;
+    // runs of narrower levels become one phase on a single worker.
+    const uint32_t gates = static_cast<uint32_t>(gateCount);
+    const size_t minSplit = threadCount * CHUNK_STATES * 2;
+    phases.push_back({PhaseKind::Gather, 0, gates, true});
+    bool anySplit = false;
+    for (int level = 0; level <= maxLevel; ++level) {
+        const uint32_t begin = levelStart[level];
+        const uint32_t end = levelStart[level + 1];
+        if (begin == end) continue;
+        const bool split = end - begin >= minSplit;
+        anySplit = anySplit || split;
+        if (!split && !phases.back().split && phases.back().kind == PhaseKind::Evaluate) {
+            phases.back().end = end;
+        } else {
+            phases.push_back({PhaseKind::Evaluate, begin, end, split});
+        }
+    }
+    phases.push_back({PhaseKind::Scatter, 0, gates, true});
+
+    if (!anySplit) {
+        phases.clear();
+        return;
+    }
+
+    // Chunk boundaries are multiples of CHUNK_STATES, so the values array
+    // itself must start on a cache line.
+    buffer.assign(gateCount + CHUNK_STATES, 0);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(buffer.data());
+    values = buffer.data() + (CHUNK_STATES - address % CHUNK_STATES) % CHUNK_STATES;
+    parallel = true;
+}
+
+void LevelParallelEvaluator::evaluateRange(uint32_t begin, uint32_t end) {
+    for (uint32_t position = begin; position < end; ++position) {
+        const GateType type = typeAt[position];
+        if (CompiledCircuit::isSource(type)) continue;
+
+        const uint32_t* first = drivers.data() + driverOffsets[position];
+        const size_t count = driverOffsets[position + 1] - driverOffsets[position];
+        if (type == GateType::LATCH) {
+            if (first[1] == NO_DRIVER || !values[first[1]]) continue;
+            values[position] = first[0] != NO_DRIVER && values[first[0]];
+            continue;
+        }
+
+        const size_t width = std::min<size_t>(count, MAX_GATE_INPUTS);
+        uint64_t inputs = 0;
+        for (size_t k = 0; k < width; ++k) inputs |= static_cast<uint64_t>(values[first[k]] & 1) << k;
+        values[position] = CompiledCircuit::evaluateGate(type, count, inputs);
+    }
+}
+
+void LevelParallelEvaluator::runPhase(const Phase& phase, uint32_t begin, uint32_t end, std::vector<uint8_t>& states) {
+    switch (phase.kind) {
+        case PhaseKind::Gather:
+            for (uint32_t position = begin; position < end; ++position) values[position] = states[gateAt[position]];
+            break;
+        case PhaseKind::Evaluate:
+            evaluateRange(begin, end);
+            break;
+        case PhaseKind::Scatter:
+            for (uint32_t position = begin; position < end; ++position) {
+                if (!CompiledCircuit::isSource(typeAt[position])) states[gateAt[position]] = values[position];
+            }
+            break;
+    }
+}
+
+void LevelParallelEvaluator::runWorker(size_t worker, std::vector<uint8_t>& states, SpinBarrier& barrier) {
+    const size_t workers = pool.getThreadCount();
+    // Rounds a split point down to a chunk boundary, staying inside the phase.
+    auto boundary = [](const Phase& phase, size_t index, size_t count) {
+        if (index == 0) return phase.begin;
+        if (index == count) return phase.end;
+        const uint64_t split = phase.begin + static_cast<uint64_t>(phase.end - phase.begin) * index / count;
+        return std::max(phase.begin, static_cast<uint32_t>(split / CHUNK_STATES * CHUNK_STATES));
+    };
+
+    for (size_t p = 0; p < phases.size(); ++p) {
+        const Phase& phase = phases[p];
+        if (phase.split) {
+            const uint32_t begin = boundary(phase, worker, workers);
+            const uint32_t end = boundary(phase, worker + 1, workers);
+            if (begin < end) runPhase(phase, begin, end, states);
+        } else if (worker == 0) {
+            runPhase(phase, phase.begin, phase.end, states);
+        }
+        if (p + 1 < phases.size()) barrier.arriveAndWait();
+    }
+}
+
+void LevelParallelEvaluator::evaluate(std::vector<uint8_t>& states) {
+    if (!circuit) return;
+    if (!parallel) {
+        circuit->evaluate(states);
+        return;
+    }
+    if (states.size() != gateAt.size()) return;
+
+    const size_t workers = pool.getThreadCount();
+    SpinBarrier barrier(workers);
+    // One task per worker: every task must be running for the barriers to
+    // open, and the pool never runs two tasks on one worker at once.
+    for (size_t worker = 0; worker < workers; ++worker) {
+        pool.submit([this, worker, &states, &barrier] { runWorker(worker, states, barrier); });
+    }
+    pool.wait();
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "CompiledCircuit.hpp"
+#include "SpinBarrier.hpp"
+#include "ThreadPool.hpp"
+
+// Evaluates a levelized circuit on several threads. Gates are renumbered by
+// level, so each level is a contiguous range of a private state array; wide
+// levels are split across the workers in chunks of whole cache lines and
+// consecutive narrow levels run on one worker, with a barrier only between
+// these phases. Circuits below the threshold, or with no level wide enough
+// to split, are handed to CompiledCircuit::evaluate() unchanged.
+class LevelParallelEvaluator {
+   private:
+    enum class PhaseKind { Gather, Evaluate, Scatter };
+    struct Phase {
+        PhaseKind kind;
+        uint32_t begin;
+        uint32_t end;
+        bool split;
+    };
+
+    ThreadPool pool;
+    size_t threshold;
+    const CompiledCircuit* circuit = nullptr;
+    bool parallel = false;
+
+    // Indexed by position: the gate placed there, its type and its drivers'
+    // positions in [driverOffsets[p], driverOffsets[p + 1]) of drivers. A
+    // latch lists its D and EN drivers in pin order, NO_DRIVER if unwired.
+    std::vector<uint32_t> gateAt;
+    std::vector<GateType> typeAt;
+    std::vector<uint32_t> driverOffsets;
+    std::vector<uint32_t> drivers;
+    std::vector<Phase> phases;
+    std::vector<uint8_t> buffer;
+    uint8_t* values = nullptr;
+
+    void evaluateRange(uint32_t begin, uint32_t end);
+    void runPhase(const Phase& phase, uint32_t begin, uint32_t end, std::vector<uint8_t>& states);
+    void runWorker(size_t worker, std::vector<uint8_t>& states, SpinBarrier& barrier);
+
+   public:
+    // States per chunk: one 64-byte cache line.
+    static constexpr uint32_t CHUNK_STATES = 64;
+    static constexpr size_t DEFAULT_THRESHOLD = 1 << 15;
+    static constexpr uint32_t NO_DRIVER = UINT32_MAX;
+
+    explicit LevelParallelEvaluator(size_t threadCount = 0, size_t threshold = DEFAULT_THRESHOLD);
+
+    // Builds the schedule for a compiled, refreshed circuit. Must be called
+    // again after the circuit changes.
+    void prepare(const CompiledCircuit& compiledCircuit);
+
+    // Same result as CompiledCircuit::evaluate(states).
+    void evaluate(std::vector<uint8_t>& states);
+
+    // Whether evaluate() runs on the pool for the prepared circuit.
+    bool isParallel() const { return parallel; }
+    size_t getPhaseCount() const { return phases.size(); }
+    size_t getThreadCount() const { return pool.getThreadCount(); }
+};
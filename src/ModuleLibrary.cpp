@@ -0,0 +1,158 @@
+#include "ModuleLibrary.hpp"
+
+#include <cstdint>
+#include <functional>
+
+int ModuleLibrary::define(const std::string& name, const Netlist& definition) {
+    if (name.empty() || indexByName.count(name)) return -1;
+    for (size_t i = 0; i < definition.getGateCount(); ++i) {
+        if (definition.getType(i) == GateType::MODULE && (definition.getModule(i) < 0 || definition.getModule(i) >= static_cast<int>(size()))) {
+            return -1;
+        }
+    }
+
+    indexByName[name] = definitions.size();
+    names.push_back(name);
+    definitions.push_back(definition);
+    flattened.emplace_back();
+    return static_cast<int>(definitions.size() - 1);
+}
+
+int ModuleLibrary::find(const std::string& name) const {
+    auto it = indexByName.find(name);
+    return it == indexByName.end() ? -1 : static_cast<int>(it->second);
+}
+
+void ModuleLibrary::clear() {
+    names.clear();
+    definitions.clear();
+    indexByName.clear();
+    flattened.clear();
+}
+
+const ModuleLibrary::FlatDefinition& ModuleLibrary::getFlatDefinition(size_t definition) const {
+    if (flattened[definition]) return *flattened[definition];
+
+    auto entry = std::make_unique<FlatDefinition>();
+    flatten(definitions[definition], entry->netlist);
+
+    const Netlist& netlist = entry->netlist;
+    const size_t gateCount = netlist.getGateCount();
+    entry->bodyIndex.assign(gateCount, SIZE_MAX);
+    entry->inputPin.assign(gateCount, -1);
+    for (size_t i = 0; i < gateCount; ++i) {
+        if (netlist.getType(i) != GateType::INPUT && netlist.getType(i) != GateType::OUTPUT) {
+            entry->bodyIndex[i] = entry->bodySize++;
+        }
+    }
+
+    const std::vector<size_t> inputs = netlist.getInputGates();
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        entry->inputPin[inputs[k]] = static_cast<int>(k);
+    }
+
+    // An OUTPUT gate follows its first driver.
+    for (size_t output : netlist.getOutputGates()) {
+        size_t driver = SIZE_MAX;
+        for (const Connection& c : netlist.getConnections()) {
+            if (c.dstGate == output) {
+                driver = c.srcGate;
+                break;
+            }
+        }
+        entry->outputDrivers.push_back(driver);
+    }
+
+    flattened[definition] = std::move(entry);
+    return *flattened[definition];
+}
+
+void ModuleLibrary::flatten(const Netlist& netlist, Netlist& flat, std::vector<InstanceRange>* instances) const {
+    flat.clear();
+    if (instances) instances->clear();
+
+    const size_t gateCount = netlist.getGateCount();
+    std::vector<size_t> mapped(gateCount, SIZE_MAX);
+    std::vector<const FlatDefinition*> bodies(gateCount, nullptr);
+
+    for (size_t g = 0; g < gateCount; ++g) {
+        const int definition = netlist.getModule(g);
+        if (definition < 0 || definition >= static_cast<int>(size())) {
+            if (netlist.getType(g) == GateType::MODULE) continue;
+            mapped[g] = flat.addGate(netlist.getType(g), netlist.getLabel(g), netlist.getName(g));
+            flat.setDelay(mapped[g], netlist.getDelay(g));
+            continue;
+        }
+
+        const FlatDefinition& body = getFlatDefinition(definition);
+        bodies[g] = &body;
+        mapped[g] = flat.getGateCount();
+        const std::string prefix = netlist.getName(g) + ".";
+        for (size_t h = 0; h < body.netlist.getGateCount(); ++h) {
+            if (body.bodyIndex[h] == SIZE_MAX) continue;
+            const size_t gate = flat.addGate(body.netlist.getType(h), -1, prefix + body.netlist.getName(h));
+            flat.setDelay(gate, body.netlist.getDelay(h));
+        }
+        if (instances) instances->push_back({g, static_cast<size_t>(definition), mapped[g], body.bodySize, {}});
+    }
+
+    // Driver of each instance input pin; the first wire wins, as for gates.
+    std::vector<std::vector<const Connection*>> pinDrivers(gateCount);
+    for (const Connection& c : netlist.getConnections()) {
+        if (c.dstGate >= gateCount || !bodies[c.dstGate] || c.dstPin < 0) continue;
+        std::vector<const Connection*>& pins = pinDrivers[c.dstGate];
+        if (pins.size() <= static_cast<size_t>(c.dstPin)) pins.resize(c.dstPin + 1, nullptr);
+        if (!pins[c.dstPin]) pins[c.dstPin] = &c;
+    }
+
+    // Flat gate seen through (gate, output pin). Chains of pass-through pins
+    // are followed, bounded by the gate count so wired loops terminate.
+    std::function<size_t(size_t, int, size_t)> resolve = [&](size_t gate, int pin, size_t depth) -> size_t {
+        if (gate >= gateCount || depth > gateCount) return SIZE_MAX;
+        const FlatDefinition* body = bodies[gate];
+        if (!body) return mapped[gate];
+
+        const size_t outputPin = pin < 0 ? 0 : static_cast<size_t>(pin);
+        if (outputPin >= body->outputDrivers.size() || body->outputDrivers[outputPin] == SIZE_MAX) return SIZE_MAX;
+
+        const size_t driver = body->outputDrivers[outputPin];
+        if (body->bodyIndex[driver] != SIZE_MAX) return mapped[gate] + body->bodyIndex[driver];
+
+        const int inputPin = body->inputPin[driver];
+        const std::vector<const Connection*>& pins = pinDrivers[gate];
+        if (inputPin < 0 || static_cast<size_t>(inputPin) >= pins.size() || !pins[inputPin]) return SIZE_MAX;
+        return resolve(pins[inputPin]->srcGate, pins[inputPin]->srcPin, depth + 1);
+    };
+
+    if (instances) {
+        for (InstanceRange& instance : *instances) {
+            const size_t outputCount = bodies[instance.gate]->outputDrivers.size();
+            for (size_t k = 0; k < outputCount; ++k) instance.outputGates.push_back(resolve(instance.gate, static_cast<int>(k), 0));
+        }
+    }
+
+    for (const Connection& c : netlist.getConnections()) {
+        if (c.dstGate >= gateCount || bodies[c.dstGate] || mapped[c.dstGate] == SIZE_MAX) continue;
+        const size_t src = resolve(c.srcGate, c.srcPin, 0);
+        if (src != SIZE_MAX) flat.addConnection(src, -1, mapped[c.dstGate], c.dstPin);
+    }
+
+    for (size_t g = 0; g < gateCount; ++g) {
+        const FlatDefinition* body = bodies[g];
+        if (!body) continue;
+
+        for (const Connection& c : body->netlist.getConnections()) {
+            if (body->bodyIndex[c.dstGate] == SIZE_MAX) continue;
+
+            size_t src = SIZE_MAX;
+            if (body->bodyIndex[c.srcGate] != SIZE_MAX) {
+                src = mapped[g] + body->bodyIndex[c.srcGate];
+            } else if (body->inputPin[c.srcGate] >= 0) {
+                const std::vector<const Connection*>& pins = pinDrivers[g];
+                const size_t inputPin = static_cast<size_t>(body->inputPin[c.srcGate]);
+                if (inputPin < pins.size() && pins[inputPin]) src = resolve(pins[inputPin]->srcGate, pins[inputPin]->srcPin, 0);
+            }
+            if (src != SIZE_MAX) flat.addConnection(src, -1, mapped[g] + body->bodyIndex[c.dstGate], c.dstPin);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Netlist.hpp"
+
+// Gates stamped out for one MODULE gate by ModuleLibrary::flatten. They sit
+// in one contiguous run, so an instance's state is a slice of the flat state
+// array. outputGates holds the flat gate seen on each output pin, SIZE_MAX
+// where nothing drives it.
+struct InstanceRange {
+    size_t gate;
+    size_t definition;
+    size_t firstGate;
+    size_t gateCount;
+    std::vector<size_t> outputGates;
+};
+
+// Named module definitions, each stored once however often it is used. A
+// definition is a Netlist whose INPUT and OUTPUT gates are its pins, in
+// declaration order, and which may itself instantiate earlier definitions.
+// Flattening a definition is cached, so instantiating it again is a plain
+// copy of its gates with shifted indices. The cache is not thread-safe.
+class ModuleLibrary {
+   private:
+    struct FlatDefinition {
+        Netlist netlist;
+        // Offset of each gate within an instance, SIZE_MAX for pin gates.
+        std::vector<size_t> bodyIndex;
+        std::vector<int> inputPin;
+        std::vector<size_t> outputDrivers;
+        size_t bodySize = 0;
+    };
+
+    std::vector<std::string> names;
+    std::vector<Netlist> definitions;
+    std::unordered_map<std::string, size_t> indexByName;
+    mutable std::vector<std::unique_ptr<FlatDefinition>> flattened;
+
+    const FlatDefinition& getFlatDefinition(size_t definition) const;
+
+   public:
+    // Returns the new definition's id, or -1 if the name is taken or the
+    // netlist instantiates a definition that does not exist yet.
+    int define(const std::string& name, const Netlist& definition);
+    int find(const std::string& name) const;
+    void clear();
+
+    size_t size() const { return definitions.size(); }
+    const std::string& getName(size_t definition) const { return names[definition]; }
+    const Netlist& getDefinition(size_t definition) const { return definitions[definition]; }
+
+    // The definition with every nested instance expanded; cached.
+    const Netlist& getFlattened(size_t definition) const { return getFlatDefinition(definition).netlist; }
+
+    // Expands every MODULE gate of netlist into plain gates named
+    // "<instance>.<gate>". Pins disappear: wires are joined straight through
+    // them, and unconnected pins read as unconnected inputs. Gates that are
+    // not instances keep their order, labels and delays.
+    void flatten(const Netlist& netlist, Netlist& flat, std::vector<InstanceRange>* instances = nullptr) const;
+};
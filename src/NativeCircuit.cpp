@@ -0,0 +1,229 @@
+#include "NativeCircuit.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NATIVE_CIRCUIT_DLOPEN 1
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Bumped whenever generateSource changes shape, so stale objects are ignored.
+const uint64_t CODEGEN_VERSION = 1;
+const char* ENTRY_POINT = "dls_circuit_block";
+
+// Compiler and flags every object is built with.
+std::string compilerCommand() {
+    const char* compiler = std::getenv("CXX");
+    return std::string(compiler && *compiler ? compiler : "c++") + " -std=c++17 -O1 -march=native -shared -fPIC";
+}
+
+// Objects built with -march=native may use any extension of the building
+// CPU, so caches shared between machines must tell them apart.
+uint64_t hostFeatures() {
+    uint64_t features = 0;
+#if defined(__x86_64__) || defined(__i386__)
+    int bit = 0;
+    auto add = [&](bool supported) { features |= static_cast<uint64_t>(supported) << bit++; };
+    __builtin_cpu_init();
+    add(__builtin_cpu_supports("sse3"));
+    add(__builtin_cpu_supports("ssse3"));
+    add(__builtin_cpu_supports("sse4.1"));
+    add(__builtin_cpu_supports("sse4.2"));
+    add(__builtin_cpu_supports("popcnt"));
+    add(__builtin_cpu_supports("avx"));
+    add(__builtin_cpu_supports("avx2"));
+    add(__builtin_cpu_supports("fma"));
+    add(__builtin_cpu_supports("bmi"));
+    add(__builtin_cpu_supports("bmi2"));
+    add(__builtin_cpu_supports("avx512f"));
+    add(__builtin_cpu_supports("avx512cd"));
+    add(__builtin_cpu_supports("avx512bw"));
+    add(__builtin_cpu_supports("avx512dq"));
+    add(__builtin_cpu_supports("avx512vl"));
+    add(__builtin_cpu_supports("avx512vbmi"));
+    add(__builtin_cpu_supports("avx512vbmi2"));
+    add(__builtin_cpu_supports("gfni"));
+    add(__builtin_cpu_supports("vpclmulqdq"));
+#endif
+    return features;
+}
+
+const char* getOperator(WordOpCode code) {
+    switch (code) {
+        case WordOpCode::AND:
+        case WordOpCode::NAND:
+            return " & ";
+        case WordOpCode::OR:
+        case WordOpCode::NOR:
+            return " | ";
+        default:
+            return " ^ ";
+    }
+}
+
+}  // namespace
+
+NativeCircuit::~NativeCircuit() { unload(); }
+
+void NativeCircuit::unload() {
+#ifdef NATIVE_CIRCUIT_DLOPEN
+    if (handle) dlclose(handle);
+#endif
+    handle = nullptr;
+    kernel = nullptr;
+}
+
+uint64_t NativeCircuit::hashProgram(const CompiledCircuit& circuit) {
+    // FNV-1a over everything that ends up in the generated source, plus the
+    // compiler command and the CPU extensions the object may depend on.
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    mix(CODEGEN_VERSION);
+    mix(SimdKernels::BLOCK_WORDS);
+    for (char c : compilerCommand()) mix(static_cast<unsigned char>(c));
+    mix(hostFeatures());
+    for (const WordOp& op : circuit.getProgram()) {
+        mix(static_cast<uint64_t>(op.code));
+        mix(op.dst);
+        mix(op.a);
+        mix(op.b);
+    }
+    return hash;
+}
+
+std::string NativeCircuit::generateSource(const CompiledCircuit& circuit) {
+    std::ostringstream out;
+    out << "#include <cstddef>\n#include <cstdint>\n\nstruct WordOp;\n"
+        << "typedef uint64_t Block __attribute__((vector_size(" << SimdKernels::BLOCK_WORDS * 8 << "), aligned(8)));\n\n"
+        << "extern \"C\" void " << ENTRY_POINT << "(const WordOp*, size_t, uint64_t* nets) {\n"
+        << "    Block* n = reinterpret_cast<Block*>(nets);\n";
+
+    for (const WordOp& op : circuit.getProgram()) {
+        out << "    n[" << op.dst << "] = ";
+        switch (op.code) {
+            case WordOpCode::ZERO:
+                out << "Block{}";
+                break;
+            case WordOpCode::ONES:
+                out << "~Block{}";
+                break;
+            case WordOpCode::COPY:
+                out << "n[" << op.a << "]";
+                break;
+            case WordOpCode::NOT:
+                out << "~n[" << op.a << "]";
+                break;
+            case WordOpCode::AND:
+            case WordOpCode::OR:
+            case WordOpCode::XOR:
+                out << "n[" << op.a << "]" << getOperator(op.code) << "n[" << op.b << "]";
+                break;
+            case WordOpCode::NAND:
+            case WordOpCode::NOR:
+                out << "~(n[" << op.a << "]" << getOperator(op.code) << "n[" << op.b << "])";
+                break;
+        }
+        out << ";\n";
+    }
+
+    out << "}\n";
+    return out.str();
+}
+
+std::string NativeCircuit::getCacheDirectory() {
+    if (const char* dir = std::getenv("DLSIM_CACHE_DIR"); dir && *dir) return dir;
+    if (const char* dir = std::getenv("XDG_CACHE_HOME"); dir && *dir) return std::string(dir) + "/dlsim";
+    if (const char* dir = std::getenv("HOME"); dir && *dir) return std::string(dir) + "/.cache/dlsim";
+    return "dlsim-cache";
+}
+
+bool NativeCircuit::load(const CompiledCircuit& circuit) {
+    unload();
+
+    if (!circuit.isAcyclic() || circuit.getProgram().empty()) {
+        status = "interpreter (circuit has no straight-line program)";
+        return false;
+    }
+
+#ifndef NATIVE_CIRCUIT_DLOPEN
+    status = "interpreter (no dlopen on this platform)";
+    return false;
+#else
+    char hashText[17];
+    std::snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(hashProgram(circuit)));
+    const std::string directory = getCacheDirectory();
+    const std::string base = directory + "/circuit-" + hashText;
+    const std::string objectPath = base + ".so";
+
+    std::error_code error;
+    const bool cached = std::filesystem::exists(objectPath, error);
+
+    if (!cached) {
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            status = "interpreter (cannot create " + directory + ")";
+            return false;
+        }
+
+        // Build under a per-process name and rename into place so concurrent
+        // runs never load a half-written object.
+        const std::string suffix = "." + std::to_string(getpid());
+        const std::string sourcePath = base + suffix + ".cpp";
+        const std::string tempPath = base + suffix + ".so";
+        {
+            std::ofstream source(sourcePath);
+            source << generateSource(circuit);
+            if (!source) {
+                status = "interpreter (cannot write " + sourcePath + ")";
+                return false;
+            }
+        }
+
+        const std::string command = compilerCommand() + " -o \"" + tempPath + "\" \"" + sourcePath + "\" > /dev/null 2>&1";
+        const int result = std::system(command.c_str());
+        std::filesystem::remove(sourcePath, error);
+
+        if (result != 0) {
+            std::filesystem::remove(tempPath, error);
+            status = "interpreter (no working C++ compiler)";
+            return false;
+        }
+        std::filesystem::rename(tempPath, objectPath, error);
+        if (error) {
+            std::filesystem::remove(tempPath, error);
+            status = "interpreter (cannot write " + objectPath + ")";
+            return false;
+        }
+    }
+
+    handle = dlopen(objectPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* reason = dlerror();
+        status = std::string("interpreter (") + (reason ? reason : "dlopen failed") + ")";
+        return false;
+    }
+
+    kernel = reinterpret_cast<SimdKernels::BlockKernel>(dlsym(handle, ENTRY_POINT));
+    if (!kernel) {
+        unload();
+        status = "interpreter (" + objectPath + " has no kernel)";
+        return false;
+    }
+
+    status = std::string(cached ? "native (cached " : "native (compiled ") + objectPath + ")";
+    return true;
+#endif
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "CompiledCircuit.hpp"
+#include "SimdKernels.hpp"
+
+// Optional backend that turns a compiled circuit's WordOp program into a C++
+// block kernel, builds it with the system compiler as a shared object and
+// loads it with dlopen. Objects are cached by a hash of the program, the
+// compiler command and the host's CPU extensions, so a netlist is only
+// compiled once per machine and compiler. When no compiler or dlopen is
+// available, getKernel() returns the best interpreted kernel instead, so
+// callers never need a separate path.
+class NativeCircuit {
+   private:
+    void* handle = nullptr;
+    SimdKernels::BlockKernel kernel = nullptr;
+    std::string status;
+
+    void unload();
+
+   public:
+    NativeCircuit() = default;
+    ~NativeCircuit();
+    NativeCircuit(const NativeCircuit&) = delete;
+    NativeCircuit& operator=(const NativeCircuit&) = delete;
+
+    // Returns true if a native kernel is now loaded; getStatus() explains
+    // where it came from or why the interpreter is used.
+    bool load(const CompiledCircuit& circuit);
+
+    SimdKernels::BlockKernel getKernel() const { return kernel ? kernel : SimdKernels::getBestKernel(); }
+    bool isNative() const { return handle != nullptr; }
+    const std::string& getStatus() const { return status; }
+
+    static uint64_t hashProgram(const CompiledCircuit& circuit);
+    static std::string generateSource(const CompiledCircuit& circuit);
+
+    // $DLSIM_CACHE_DIR, else $XDG_CACHE_HOME/dlsim, else ~/.cache/dlsim.
+    static std::string getCacheDirectory();
+};
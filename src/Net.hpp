@@ -0,0 +1,98 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Everything attached to one gate output: the driving pin, every input pin
+// it feeds and the line geometry for all of them. The geometry is built as
+// sinks are added, so drawing a net is a single draw call whatever its
+// fan-out, and setting its state is O(1); the colour catches up on draw.
+class Net {
+   public:
+    struct Sink {
+        size_t gate;
+        int pin;
+    };
+
+   private:
+    size_t driverGate;
+    int driverPin;
+    sf::Vector2f driverPosition;
+    std::vector<Sink> sinks;
+    std::vector<sf::Vector2f> sinkPositions;
+    mutable sf::VertexArray geometry{sf::PrimitiveType::Lines};
+    mutable bool drawnState = false;
+    bool state = false;
+
+    static sf::Color getColor(bool high) { return high ? sf::Color::Yellow : sf::Color(120, 120, 40); }
+
+    // Three parallel lines per sink give the wire its thickness.
+    void appendGeometry(sf::Vector2f end) {
+        const sf::Color color = getColor(drawnState);
+        for (float offset : {0.f, -1.f, 1.f}) {
+            geometry.append(sf::Vertex{driverPosition + sf::Vector2f{0.f, offset}, color});
+            geometry.append(sf::Vertex{end + sf::Vector2f{0.f, offset}, color});
+        }
+    }
+
+    void rebuildGeometry() {
+        geometry.clear();
+        for (sf::Vector2f position : sinkPositions) appendGeometry(position);
+    }
+
+   public:
+    Net(size_t driverGate, int driverPin, sf::Vector2f driverPosition) : driverGate(driverGate), driverPin(driverPin), driverPosition(driverPosition) {}
+
+    void addSink(size_t gate, int pin, sf::Vector2f position) {
+        sinks.push_back({gate, pin});
+        sinkPositions.push_back(position);
+        appendGeometry(position);
+    }
+
+    // Drops the connections to pins firstPin and up of the given gate and
+    // returns how many there were; O(sinks).
+    size_t removeSinksOf(size_t gate, int firstPin = 0) {
+        size_t kept = 0;
+        for (size_t i = 0; i < sinks.size(); ++i) {
+            if (sinks[i].gate == gate && sinks[i].pin >= firstPin) continue;
+            sinks[kept] = sinks[i];
+            sinkPositions[kept] = sinkPositions[i];
+            ++kept;
+        }
+        const size_t removed = sinks.size() - kept;
+        sinks.resize(kept);
+        sinkPositions.resize(kept);
+        if (removed) rebuildGeometry();
+        return removed;
+    }
+
+    // For gates whose pins moved, e.g. after a pin count change.
+    void setDriverPosition(sf::Vector2f position) {
+        driverPosition = position;
+        rebuildGeometry();
+    }
+    template <typename PinPosition>
+    void moveSinksOf(size_t gate, PinPosition pinPosition) {
+        for (size_t i = 0; i < sinks.size(); ++i) {
+            if (sinks[i].gate == gate) sinkPositions[i] = pinPosition(sinks[i].pin);
+        }
+        rebuildGeometry();
+    }
+
+    void setState(bool value) { state = value; }
+
+    void draw(sf::RenderWindow &window) const {
+        if (!window.isOpen()) return;
+        if (drawnState != state) {
+            const sf::Color color = getColor(state);
+            for (size_t i = 0; i < geometry.getVertexCount(); ++i) geometry[i].color = color;
+            drawnState = state;
+        }
+        window.draw(geometry);
+    }
+
+    size_t getDriverGate() const { return driverGate; }
+    int getDriverPin() const { return driverPin; }
+    const std::vector<Sink> &getSinks() const { return sinks; }
+    bool empty() const { return sinks.empty(); }
+    bool getState() const { return state; }
+};
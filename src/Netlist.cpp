@@ -0,0 +1,459 @@
+#include "Netlist.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "ModuleLibrary.hpp"
+
+size_t Netlist::addGate(GateType type, int label, const std::string& name) {
+    types.push_back(type);
+    labels.push_back(label);
+    names.push_back(name);
+    delays.push_back(-1);
+    modules.push_back(-1);
+    return types.size() - 1;
+}
+
+size_t Netlist::addModule(size_t definition, const std::string& name) {
+    const size_t gateIndex = addGate(GateType::MODULE, -1, name);
+    modules[gateIndex] = static_cast<int>(definition);
+    return gateIndex;
+}
+
+void Netlist::addConnection(size_t srcGate, int srcPin, size_t dstGate, int dstPin) { connections.push_back({srcGate, srcPin, dstGate, dstPin}); }
+
+void Netlist::clear() {
+    types.clear();
+    labels.clear();
+    names.clear();
+    delays.clear();
+    modules.clear();
+    connections.clear();
+}
+
+std::vector<size_t> Netlist::getInputGates() const {
+    std::vector<size_t> inputs;
+    for (size_t i = 0; i < types.size(); ++i) {
+        if (types[i] == GateType::INPUT) inputs.push_back(i);
+    }
+    return inputs;
+}
+
+std::vector<size_t> Netlist::getOutputGates() const {
+    std::vector<size_t> outputs;
+    for (size_t i = 0; i < types.size(); ++i) {
+        if (types[i] == GateType::OUTPUT) outputs.push_back(i);
+    }
+    return outputs;
+}
+
+std::string Netlist::getInputLabelName(int label) {
+    // Spreadsheet-style: A..Z, AA..ZZ, AAA...
+    std::string name;
+    for (long long n = static_cast<long long>(label) + 1; n > 0; n = (n - 1) / 26) {
+        name.insert(name.begin(), static_cast<char>('A' + (n - 1) % 26));
+    }
+    return name;
+}
+
+std::string Netlist::getOutputLabelName(int label) { return "Y" + std::to_string(label + 1); }
+
+std::string Netlist::getGateLabelString(size_t gateIndex) const {
+    if (gateIndex >= types.size()) return "?";
+
+    switch (types[gateIndex]) {
+        case GateType::INPUT:
+            return labels[gateIndex] >= 0 ? getInputLabelName(labels[gateIndex]) : "IN";
+        case GateType::OUTPUT:
+            return labels[gateIndex] >= 0 ? getOutputLabelName(labels[gateIndex]) : "OUT";
+        default:
+            return getGateTypeName(types[gateIndex]);
+    }
+}
+
+std::vector<std::vector<size_t>> Netlist::buildDriverIndex() const {
+    std::vector<std::vector<size_t>> drivers(types.size());
+    for (const Connection& connection : connections) {
+        if (connection.dstGate >= types.size() || connection.srcGate >= types.size()) continue;
+        if (connection.srcGate == connection.dstGate) continue;
+        drivers[connection.dstGate].push_back(connection.srcGate);
+    }
+    return drivers;
+}
+
+std::string Netlist::generateExpressionForGate(size_t gateIndex, std::map<size_t, std::string>& expressions) const {
+    return generateExpression(gateIndex, buildDriverIndex(), expressions);
+}
+
+std::string Netlist::generateExpression(size_t gateIndex, const std::vector<std::vector<size_t>>& drivers,
+                                        std::map<size_t, std::string>& expressions) const {
+    if (gateIndex >= types.size()) return "0";
+    if (auto it = expressions.find(gateIndex); it != expressions.end()) {
+        return it->second;
+    }
+
+    auto isLeaf = [this](size_t gate) {
+        const GateType type = types[gate];
+        return type == GateType::INPUT || type == GateType::DFF || type == GateType::LATCH || type == GateType::CLOCK || type == GateType::MODULE;
+    };
+
+    // Count how often each new subexpression is read, so it can be dropped
+    // after its last reader is built; keeping every intermediate string of a
+    // long chain would need quadratic memory.
+    std::unordered_map<size_t, int> readers;
+    std::unordered_set<size_t> cone{gateIndex};
+    std::vector<size_t> stack{gateIndex};
+    while (!stack.empty()) {
+        const size_t gate = stack.back();
+        stack.pop_back();
+        if (isLeaf(gate)) continue;
+        for (size_t driver : drivers[gate]) {
+            if (expressions.count(driver)) continue;
+            ++readers[driver];
+            if (cone.insert(driver).second) stack.push_back(driver);
+        }
+    }
+
+    // Depth-first with an explicit stack so long chains cannot overflow the
+    // call stack. A driver that is still open is on a combinational loop and
+    // reads as "0", like stored state does.
+    std::unordered_set<size_t> open;
+    std::unordered_set<size_t> built;
+    stack.push_back(gateIndex);
+    while (!stack.empty()) {
+        const size_t gate = stack.back();
+        if (expressions.count(gate) || built.count(gate)) {
+            stack.pop_back();
+            continue;
+        }
+
+        if (!isLeaf(gate) && open.insert(gate).second) {
+            for (size_t driver : drivers[gate]) {
+                if (!expressions.count(driver) && !built.count(driver) && !open.count(driver)) stack.push_back(driver);
+            }
+            continue;
+        }
+        stack.pop_back();
+        expressions[gate] = buildExpression(gate, drivers[gate], expressions);
+        built.insert(gate);
+
+        for (size_t driver : drivers[gate]) {
+            auto it = readers.find(driver);
+            if (it != readers.end() && --it->second == 0 && built.count(driver)) expressions.erase(driver);
+        }
+    }
+    return expressions[gateIndex];
+}
+
+std::string Netlist::buildExpression(size_t gateIndex, const std::vector<size_t>& drivers, const std::map<size_t, std::string>& expressions) const {
+    const GateType type = types[gateIndex];
+
+    if (type == GateType::INPUT) {
+        return labels[gateIndex] >= 0 ? getInputLabelName(labels[gateIndex]) : "0";
+    }
+
+    // Stored state has no combinational expression; stopping here also keeps
+    // registered feedback loops from being followed. Module instances only
+    // get expressions once flattened.
+    if (type == GateType::DFF || type == GateType::LATCH || type == GateType::CLOCK || type == GateType::MODULE) {
+        return "0";
+    }
+
+    std::vector<std::string> inputExprs;
+    size_t length = 0;
+    const size_t width = std::min<size_t>(drivers.size(), MAX_GATE_INPUTS);
+    for (size_t k = 0; k < width; ++k) {
+        const size_t driver = drivers[k];
+        auto it = expressions.find(driver);
+        if (it == expressions.end() || it->second == "0") continue;
+        if (it->second.empty()) return "";
+        inputExprs.push_back(it->second);
+        length += it->second.size();
+    }
+    if (length > MAX_EXPRESSION_LENGTH) return "";
+
+    std::sort(inputExprs.begin(), inputExprs.end());
+
+    if (inputExprs.empty()) return "0";
+    if (type == GateType::OUTPUT) return inputExprs[0];
+
+    if (type == GateType::NOT) return inputExprs.size() == 1 ? "~(" + inputExprs[0] + ")" : "0";
+    // A gate with a constant-0 input is reported as "0", as it always was
+    // for two inputs.
+    if (!isMultiInput(type) || inputExprs.size() < 2 || inputExprs.size() != width) return "0";
+
+    const char* op = ".";
+    if (type == GateType::OR || type == GateType::NOR) op = "+";
+    if (type == GateType::XOR) op = "^";
+    std::string joined = inputExprs[0];
+    for (size_t k = 1; k < inputExprs.size(); ++k) joined += op + inputExprs[k];
+
+    const bool inverted = type == GateType::NAND || type == GateType::NOR;
+    return (inverted ? "~(" : "(") + joined + ")";
+}
+
+std::string Netlist::getGateSymbol(GateType type) const {
+    switch (type) {
+        case GateType::AND:
+            return ".";
+        case GateType::OR:
+            return "+";
+        case GateType::NOT:
+            return "~";
+        case GateType::NAND:
+            return "NAND";
+        case GateType::NOR:
+            return "NOR";
+        case GateType::XOR:
+            return "^";
+        default:
+            return "";
+    }
+}
+
+std::string Netlist::getExactEquation() const {
+    std::vector<std::string> outputExpressions = getAllOutputEquations();
+
+    for (const std::string& expr : outputExpressions) {
+        if (!expr.empty() && expr != "0") return expr;
+    }
+
+    return outputExpressions.empty() ? "" : "0";
+}
+
+std::vector<std::string> Netlist::getAllOutputEquations() const {
+    std::vector<std::string> outputExpressions;
+
+    // Shared subexpressions are built once for all outputs.
+    const std::vector<std::vector<size_t>> drivers = buildDriverIndex();
+    std::map<size_t, std::string> expressions;
+    for (size_t outputIndex : getOutputGates()) {
+        outputExpressions.push_back(generateExpression(outputIndex, drivers, expressions));
+    }
+
+    return outputExpressions;
+}
+
+bool Netlist::parseGateType(const std::string& text, GateType& type) {
+    static const std::pair<const char*, GateType> names[] = {
+        {"AND", GateType::AND}, {"OR", GateType::OR},     {"NOT", GateType::NOT},     {"NAND", GateType::NAND},
+        {"NOR", GateType::NOR}, {"XOR", GateType::XOR}, {"INPUT", GateType::INPUT}, {"OUTPUT", GateType::OUTPUT},
+        {"DFF", GateType::DFF}, {"LATCH", GateType::LATCH}, {"CLOCK", GateType::CLOCK},
+    };
+
+    std::string upper = text;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    for (const auto& entry : names) {
+        if (upper == entry.first) {
+            type = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* Netlist::getGateTypeName(GateType type) {
+    switch (type) {
+        case GateType::AND:
+            return "AND";
+        case GateType::OR:
+            return "OR";
+        case GateType::NOT:
+            return "NOT";
+        case GateType::NAND:
+            return "NAND";
+        case GateType::NOR:
+            return "NOR";
+        case GateType::XOR:
+            return "XOR";
+        case GateType::INPUT:
+            return "INPUT";
+        case GateType::OUTPUT:
+            return "OUTPUT";
+        case GateType::DFF:
+            return "DFF";
+        case GateType::LATCH:
+            return "LATCH";
+        case GateType::CLOCK:
+            return "CLOCK";
+        case GateType::MODULE:
+            return "MODULE";
+        default:
+            return "?";
+    }
+}
+
+namespace {
+
+struct PendingGate {
+    std::vector<std::string> sources;
+    int line;
+};
+
+// One netlist body, the top level or a MODULE block, while it is read.
+struct BodyReader {
+    Netlist netlist;
+    std::unordered_map<std::string, size_t> indexByName;
+    std::vector<PendingGate> pending;
+    int nextInputLabel = 0;
+    int nextOutputLabel = 0;
+};
+
+std::string atLine(int lineNumber) { return "line " + std::to_string(lineNumber) + ": "; }
+
+bool readGate(BodyReader& body, const ModuleLibrary& library, std::istringstream& fields, const std::string& typeName, int lineNumber,
+              std::string& error) {
+    GateType type = GateType::MODULE;
+    const int definition = Netlist::parseGateType(typeName, type) ? -1 : library.find(typeName);
+    if (type == GateType::MODULE && definition < 0) {
+        error = atLine(lineNumber) + "unknown gate type '" + typeName + "'";
+        return false;
+    }
+
+    std::string name;
+    if (!(fields >> name) || body.indexByName.count(name)) {
+        error = atLine(lineNumber) + "missing or duplicate gate name";
+        return false;
+    }
+    if (name.find('.') != std::string::npos) {
+        error = atLine(lineNumber) + "gate names cannot contain '.'";
+        return false;
+    }
+
+    int label = -1;
+    if (type == GateType::INPUT) label = body.nextInputLabel++;
+    if (type == GateType::OUTPUT) label = body.nextOutputLabel++;
+
+    const size_t gateIndex = definition >= 0 ? body.netlist.addModule(definition, name) : body.netlist.addGate(type, label, name);
+    body.indexByName[name] = gateIndex;
+
+    PendingGate gate{{}, lineNumber};
+    for (std::string source; fields >> source;) {
+        if (source[0] != '@') {
+            gate.sources.push_back(source);
+            continue;
+        }
+
+        char* end = nullptr;
+        long delay = std::strtol(source.c_str() + 1, &end, 10);
+        if (source.size() == 1 || *end != '\0' || delay < 0 || definition >= 0) {
+            error = atLine(lineNumber) + "bad delay '" + source + "'";
+            return false;
+        }
+        body.netlist.setDelay(gateIndex, static_cast<int>(delay));
+    }
+
+    if (definition >= 0 && gate.sources.size() > library.getDefinition(definition).getInputGates().size()) {
+        error = atLine(lineNumber) + "too many sources for module '" + typeName + "'";
+        return false;
+    }
+    if (gate.sources.size() > static_cast<size_t>(MAX_GATE_INPUTS)) {
+        error = atLine(lineNumber) + "more than " + std::to_string(MAX_GATE_INPUTS) + " sources";
+        return false;
+    }
+    body.pending.push_back(gate);
+    return true;
+}
+
+// Resolves every source once the whole body is known, so gates may refer to
+// names declared further down.
+bool connectBody(BodyReader& body, const ModuleLibrary& library, std::string& error) {
+    for (size_t dst = 0; dst < body.pending.size(); ++dst) {
+        const PendingGate& gate = body.pending[dst];
+        for (size_t pin = 0; pin < gate.sources.size(); ++pin) {
+            const std::string& source = gate.sources[pin];
+            const size_t dot = source.find('.');
+            auto it = body.indexByName.find(source.substr(0, dot));
+            if (it == body.indexByName.end()) {
+                error = atLine(gate.line) + "unknown source '" + source + "'";
+                return false;
+            }
+
+            int srcPin = -1;
+            const int definition = body.netlist.getModule(it->second);
+            if (definition >= 0) {
+                const Netlist& module = library.getDefinition(definition);
+                const std::vector<size_t> outputs = module.getOutputGates();
+                for (size_t k = 0; k < outputs.size(); ++k) {
+                    if (dot == std::string::npos ? outputs.size() == 1 : module.getName(outputs[k]) == source.substr(dot + 1)) {
+                        srcPin = static_cast<int>(k);
+                    }
+                }
+            }
+            if ((definition >= 0) != (srcPin >= 0)) {
+                error = atLine(gate.line) + "bad output pin in '" + source + "'";
+                return false;
+            }
+
+            body.netlist.addConnection(it->second, srcPin, dst, static_cast<int>(pin));
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool Netlist::load(std::istream& in, ModuleLibrary& library, std::string& error) {
+    clear();
+
+    BodyReader top;
+    BodyReader module;
+    std::string moduleName;
+    bool inModule = false;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        std::string typeName;
+        if (!(fields >> typeName)) continue;
+
+        if (typeName == "MODULE") {
+            GateType type;
+            if (inModule || !(fields >> moduleName) || library.find(moduleName) >= 0 || parseGateType(moduleName, type)) {
+                error = atLine(lineNumber) + "bad, nested or duplicate MODULE";
+                return false;
+            }
+            module = BodyReader();
+            inModule = true;
+            continue;
+        }
+
+        if (typeName == "END") {
+            if (!inModule) {
+                error = atLine(lineNumber) + "END without MODULE";
+                return false;
+            }
+            if (!connectBody(module, library, error)) return false;
+            library.define(moduleName, module.netlist);
+            inModule = false;
+            continue;
+        }
+
+        if (!readGate(inModule ? module : top, library, fields, typeName, lineNumber, error)) return false;
+    }
+
+    if (inModule) {
+        error = "MODULE " + moduleName + " is missing END";
+        return false;
+    }
+    if (!connectBody(top, library, error)) return false;
+
+    *this = top.netlist;
+    return true;
+}
+
+bool Netlist::load(std::istream& in, std::string& error) {
+    ModuleLibrary library;
+    Netlist top;
+    if (!top.load(in, library, error)) return false;
+
+    library.flatten(top, *this);
+    return true;
+}
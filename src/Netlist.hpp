@@ -0,0 +1,89 @@
+#pragma once
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "GateType.hpp"
+
+class ModuleLibrary;
+
+struct Connection {
+    size_t srcGate;
+    int srcPin;
+    size_t dstGate;
+    int dstPin;
+};
+
+// Graphics-free description of a circuit: gate types, I/O labels and the
+// connections between them. This is what the evaluation engines compile,
+// and it can be built either from the editor's Circuit or from a text file.
+class Netlist {
+   private:
+    std::vector<GateType> types;
+    std::vector<int> labels;
+    std::vector<std::string> names;
+    std::vector<int> delays;
+    std::vector<int> modules;
+    std::vector<Connection> connections;
+
+    std::vector<std::vector<size_t>> buildDriverIndex() const;
+    std::string generateExpression(size_t gateIndex, const std::vector<std::vector<size_t>>& drivers, std::map<size_t, std::string>& expressions) const;
+    std::string buildExpression(size_t gateIndex, const std::vector<size_t>& drivers, const std::map<size_t, std::string>& expressions) const;
+
+   public:
+    size_t addGate(GateType type, int label = -1, const std::string& name = "");
+    // Adds a MODULE gate instantiating the given library definition. Its
+    // connections use dstPin for the module's input pin and srcPin for the
+    // output pin read by the destination.
+    size_t addModule(size_t definition, const std::string& name = "");
+    void addConnection(size_t srcGate, int srcPin, size_t dstGate, int dstPin);
+    void clear();
+
+    size_t getGateCount() const { return types.size(); }
+    GateType getType(size_t gateIndex) const { return types[gateIndex]; }
+    int getLabel(size_t gateIndex) const { return labels[gateIndex]; }
+    const std::string& getName(size_t gateIndex) const { return names[gateIndex]; }
+    // Library definition of a MODULE gate, -1 for every other gate.
+    int getModule(size_t gateIndex) const { return modules[gateIndex]; }
+
+    // Per-instance propagation delay in simulation ticks; -1 means the
+    // default for the gate type.
+    void setDelay(size_t gateIndex, int delay) { delays[gateIndex] = delay; }
+    int getDelay(size_t gateIndex) const { return delays[gateIndex]; }
+    const std::vector<GateType>& getTypes() const { return types; }
+    const std::vector<Connection>& getConnections() const { return connections; }
+
+    std::vector<size_t> getInputGates() const;
+    std::vector<size_t> getOutputGates() const;
+    std::string getGateLabelString(size_t gateIndex) const;
+
+    // Exact expression over the input labels, "0" when the gate has none
+    // and "" when it would be longer than MAX_EXPRESSION_LENGTH.
+    std::string generateExpressionForGate(size_t gateIndex, std::map<size_t, std::string>& expressions) const;
+    std::string getGateSymbol(GateType type) const;
+    std::string getExactEquation() const;
+    std::vector<std::string> getAllOutputEquations() const;
+
+    static constexpr size_t MAX_EXPRESSION_LENGTH = 1 << 14;
+
+    static bool parseGateType(const std::string& text, GateType& type);
+    static const char* getGateTypeName(GateType type);
+    // Label shown for the n-th INPUT (A..Z, AA, AB, ...) and OUTPUT (Y1, Y2, ...).
+    static std::string getInputLabelName(int label);
+    static std::string getOutputLabelName(int label);
+
+    // Reads the text netlist format used by the batch driver. One gate per
+    // line, "<TYPE> <name> [source...] [@delay]", where sources name other
+    // gates and may be declared later in the file; '#' starts a comment.
+    // INPUT and OUTPUT gates are labelled in declaration order.
+    //
+    // "MODULE <name>" ... "END" defines a module whose INPUT and OUTPUT gates
+    // are its pins. Later lines instantiate it as "<module> <name> [source...]",
+    // with sources bound to the input pins in order, and read its outputs as
+    // "<instance>.<output name>" (or just "<instance>" for a single output).
+    // This overload adds the definitions to library and keeps instances as
+    // MODULE gates; the two-argument one returns the flattened circuit.
+    bool load(std::istream& in, ModuleLibrary& library, std::string& error);
+    bool load(std::istream& in, std::string& error);
+};
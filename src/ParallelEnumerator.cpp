@@ -0,0 +1,70 @@
+#include "ParallelEnumerator.hpp"
+
+#include <algorithm>
+
+// Chunks must start on a kernel block boundary.
+ParallelEnumerator::ParallelEnumerator(size_t threadCount, uint64_t chunkWords)
+    : pool(threadCount), chunkWords(std::max<uint64_t>(SimdKernels::BLOCK_WORDS, chunkWords / SimdKernels::BLOCK_WORDS * SimdKernels::BLOCK_WORDS)) {}
+
+size_t ParallelEnumerator::forEachChunk(uint64_t numWords, const std::function<void(uint64_t, uint64_t, size_t)>& chunkFn) {
+    size_t chunkCount = 0;
+    for (uint64_t first = 0; first < numWords; first += chunkWords) {
+        const uint64_t end = std::min(numWords, first + chunkWords);
+        const size_t index = chunkCount++;
+        pool.submit([&chunkFn, first, end, index] { chunkFn(first, end, index); });
+    }
+    pool.wait();
+    return chunkCount;
+}
+
+EnumerationResult ParallelEnumerator::enumerate(const CompiledCircuit& circuit, bool collectMinterms) {
+    return enumerate(circuit, SimdKernels::detectLevel(), collectMinterms);
+}
+
+EnumerationResult ParallelEnumerator::enumerate(const CompiledCircuit& circuit, SimdLevel level, bool collectMinterms) {
+    return enumerate(circuit, SimdKernels::getKernel(level), collectMinterms);
+}
+
+EnumerationResult ParallelEnumerator::enumerate(const CompiledCircuit& circuit, SimdKernels::BlockKernel kernel, bool collectMinterms) {
+    EnumerationResult result;
+    const size_t numInputs = circuit.getInputGates().size();
+    const size_t numOutputs = circuit.getOutputGates().size();
+    if (!circuit.isCombinational() || numInputs >= 64) return result;
+
+    const uint64_t numWords = ((1ULL << numInputs) + 63) / 64;
+    result.outputBits.assign(numOutputs, std::vector<uint64_t>(numWords, 0));
+
+    // chunkMinterms[chunk][output]
+    std::vector<std::vector<std::vector<uint64_t>>> chunkMinterms;
+    if (collectMinterms) {
+        chunkMinterms.resize((numWords + chunkWords - 1) / chunkWords, std::vector<std::vector<uint64_t>>(numOutputs));
+    }
+
+    forEachChunk(numWords, [&](uint64_t first, uint64_t end, size_t chunk) {
+        circuit.sweepTruthTable(first, end, kernel, result.outputBits);
+        if (!collectMinterms) return;
+
+        for (size_t k = 0; k < numOutputs; ++k) {
+            std::vector<uint64_t>& minterms = chunkMinterms[chunk][k];
+            for (uint64_t w = first; w < end; ++w) {
+                for (uint64_t bits = result.outputBits[k][w]; bits; bits &= bits - 1) {
+                    minterms.push_back(w * 64 + __builtin_ctzll(bits));
+                }
+            }
+        }
+    });
+
+    if (collectMinterms) {
+        result.minterms.resize(numOutputs);
+        for (size_t k = 0; k < numOutputs; ++k) {
+            size_t total = 0;
+            for (const auto& chunk : chunkMinterms) total += chunk[k].size();
+            result.minterms[k].reserve(total);
+            for (const auto& chunk : chunkMinterms) {
+                result.minterms[k].insert(result.minterms[k].end(), chunk[k].begin(), chunk[k].end());
+            }
+        }
+    }
+
+    return result;
+}
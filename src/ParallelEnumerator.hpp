@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "CompiledCircuit.hpp"
+#include "ThreadPool.hpp"
+
+struct EnumerationResult {
+    // One packed bitset per OUTPUT gate, laid out like CompiledCircuit::generateTruthTable.
+    std::vector<std::vector<uint64_t>> outputBits;
+    // Ascending row indices where each output is 1; only filled on request.
+    std::vector<std::vector<uint64_t>> minterms;
+};
+
+// Splits the 2^n input space into word-aligned chunks and evaluates them on a
+// work-stealing pool. Chunks write disjoint words of the output bitsets, so
+// only the per-chunk minterm lists need an explicit merge.
+class ParallelEnumerator {
+   private:
+    ThreadPool pool;
+    uint64_t chunkWords;
+
+   public:
+    static constexpr uint64_t DEFAULT_CHUNK_WORDS = 1024;
+
+    explicit ParallelEnumerator(size_t threadCount = 0, uint64_t chunkWords = DEFAULT_CHUNK_WORDS);
+
+    // Runs chunkFn(firstWord, endWord, chunkIndex) over [0, numWords) and
+    // waits for all chunks. Returns the number of chunks.
+    size_t forEachChunk(uint64_t numWords, const std::function<void(uint64_t, uint64_t, size_t)>& chunkFn);
+
+    EnumerationResult enumerate(const CompiledCircuit& circuit, bool collectMinterms = false);
+    EnumerationResult enumerate(const CompiledCircuit& circuit, SimdLevel level, bool collectMinterms = false);
+    EnumerationResult enumerate(const CompiledCircuit& circuit, SimdKernels::BlockKernel kernel, bool collectMinterms = false);
+
+    size_t getThreadCount() const { return pool.getThreadCount(); }
+};
@@ -0,0 +1,323 @@
+#include "PartitionedTimingSimulator.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "TimingSimulator.hpp"
+
+PartitionedTimingSimulator::PartitionedTimingSimulator(const Netlist& netlist, size_t threadCount) : pool(threadCount) {
+    compiled.compile(netlist);
+
+    const size_t gateCount = netlist.getGateCount();
+    delays.resize(gateCount);
+    for (size_t i = 0; i < gateCount; ++i) {
+        int delay = netlist.getDelay(i);
+        delays[i] = delay >= 0 ? static_cast<uint32_t>(delay) : TimingSimulator::getDefaultDelay(netlist.getType(i));
+    }
+
+    watched.assign(gateCount, 0);
+    assignPartitions(gateCount > 0 ? std::min(pool.getThreadCount(), gateCount) : 1);
+    reset();
+}
+
+void PartitionedTimingSimulator::assignPartitions(size_t count) {
+    const size_t gateCount = compiled.getGateCount();
+    auto evaluated = [&](size_t gate) { return CompiledCircuit::hasFanIn(compiled.getType(gate)); };
+
+    // Zero-delay gates are merged with their loads into clusters that are
+    // never split, otherwise an event could be due in another region within
+    // the tick it was made.
+    std::vector<uint32_t> parent(gateCount);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](uint32_t gate) {
+        while (parent[gate] != gate) gate = parent[gate] = parent[parent[gate]];
+        return gate;
+    };
+    for (size_t gate = 0; gate < gateCount; ++gate) {
+        if (delays[gate] != 0 || !evaluated(gate)) continue;
+        for (const size_t* it = compiled.fanOutBegin(gate); it != compiled.fanOutEnd(gate); ++it) {
+            parent[find(static_cast<uint32_t>(*it))] = find(static_cast<uint32_t>(gate));
+        }
+    }
+
+    // Clusters in breadth-first order from the gates without drivers, so the
+    // initial contiguous split already keeps most wires inside a region.
+    std::vector<uint32_t> bfs;
+    std::vector<uint8_t> seen(gateCount, 0);
+    for (size_t gate = 0; gate < gateCount; ++gate) {
+        if (!compiled.getFanIn(gate).empty()) continue;
+        seen[gate] = 1;
+        bfs.push_back(static_cast<uint32_t>(gate));
+    }
+    size_t unseen = 0;
+    for (size_t start = 0; bfs.size() < gateCount; ++start) {
+        // Loops with no driverless gate ahead of them start a new search.
+        if (start == bfs.size()) {
+            while (seen[unseen]) ++unseen;
+            seen[unseen] = 1;
+            bfs.push_back(static_cast<uint32_t>(unseen));
+        }
+        const size_t gate = bfs[start];
+        for (const size_t* it = compiled.fanOutBegin(gate); it != compiled.fanOutEnd(gate); ++it) {
+            if (seen[*it]) continue;
+            seen[*it] = 1;
+            bfs.push_back(static_cast<uint32_t>(*it));
+        }
+    }
+
+    std::vector<uint32_t> clusterOf(gateCount, UINT32_MAX);
+    std::vector<uint32_t> rootCluster(gateCount, UINT32_MAX);
+    std::vector<uint32_t> clusterSize;
+    for (uint32_t gate : bfs) {
+        uint32_t& cluster = rootCluster[find(gate)];
+        if (cluster == UINT32_MAX) {
+            cluster = static_cast<uint32_t>(clusterSize.size());
+            clusterSize.push_back(0);
+        }
+        clusterOf[gate] = cluster;
+        ++clusterSize[cluster];
+    }
+    const size_t clusterCount = clusterSize.size();
+    std::vector<uint32_t> clusterOffsets(clusterCount + 1, 0);
+    for (size_t gate = 0; gate < gateCount; ++gate) ++clusterOffsets[clusterOf[gate] + 1];
+    std::partial_sum(clusterOffsets.begin(), clusterOffsets.end(), clusterOffsets.begin());
+    std::vector<uint32_t> clusterGates(gateCount);
+    std::vector<uint32_t> fill(clusterOffsets.begin(), clusterOffsets.end() - 1);
+    for (uint32_t gate : bfs) clusterGates[fill[clusterOf[gate]]++] = gate;
+
+    const size_t capacity = (gateCount + count - 1) / std::max<size_t>(count, 1);
+    std::vector<uint32_t> region(clusterCount);
+    std::vector<size_t> regionSize(count, 0);
+    uint32_t current = 0;
+    for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+        if (regionSize[current] >= capacity && current + 1 < count) ++current;
+        region[cluster] = current;
+        regionSize[current] += clusterSize[cluster];
+    }
+
+    // Greedy refinement: move a cluster to the region it has the most wires
+    // to while that cuts wires and keeps the regions within a few percent.
+    const size_t maxSize = capacity + capacity / 32 + 1;
+    const size_t minSize = capacity - std::min(capacity, capacity / 32 + 1);
+    std::vector<size_t> links(count, 0);
+    for (int pass = 0; pass < 4 && count > 1; ++pass) {
+        bool moved = false;
+        for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+            std::fill(links.begin(), links.end(), 0);
+            for (uint32_t k = clusterOffsets[cluster]; k < clusterOffsets[cluster + 1]; ++k) {
+                const uint32_t gate = clusterGates[k];
+                for (size_t source : compiled.getFanIn(gate)) {
+                    if (clusterOf[source] != cluster) ++links[region[clusterOf[source]]];
+                }
+                for (const size_t* it = compiled.fanOutBegin(gate); it != compiled.fanOutEnd(gate); ++it) {
+                    if (clusterOf[*it] != cluster) ++links[region[clusterOf[*it]]];
+                }
+            }
+
+            const uint32_t from = region[cluster];
+            uint32_t best = from;
+            for (uint32_t to = 0; to < count; ++to) {
+                if (links[to] > links[best] && regionSize[to] + clusterSize[cluster] <= maxSize) best = to;
+            }
+            if (best == from || regionSize[from] < minSize + clusterSize[cluster]) continue;
+
+            regionSize[from] -= clusterSize[cluster];
+            regionSize[best] += clusterSize[cluster];
+            region[cluster] = best;
+            moved = true;
+        }
+        if (!moved) break;
+    }
+
+    owner.resize(gateCount);
+    for (size_t gate = 0; gate < gateCount; ++gate) owner[gate] = region[clusterOf[gate]];
+
+    remoteOffsets.assign(1, 0);
+    remoteRegions.clear();
+    lookahead = UINT64_MAX;
+    cutWires = 0;
+    for (size_t gate = 0; gate < gateCount; ++gate) {
+        const size_t first = remoteRegions.size();
+        for (const size_t* it = compiled.fanOutBegin(gate); it != compiled.fanOutEnd(gate); ++it) {
+            if (owner[*it] == owner[gate]) continue;
+            ++cutWires;
+            if (std::find(remoteRegions.begin() + first, remoteRegions.end(), owner[*it]) == remoteRegions.end()) {
+                remoteRegions.push_back(owner[*it]);
+            }
+        }
+        // INPUT and CLOCK events only come from setInput(), never from a window.
+        if (remoteRegions.size() > first && evaluated(gate)) lookahead = std::min<uint64_t>(lookahead, delays[gate]);
+        remoteOffsets.push_back(static_cast<uint32_t>(remoteRegions.size()));
+    }
+
+    partitions.clear();
+    for (size_t i = 0; i < count; ++i) {
+        partitions.push_back(std::make_unique<Partition>());
+        partitions.back()->outbox.resize(count);
+    }
+}
+
+void PartitionedTimingSimulator::reset() {
+    const size_t gateCount = compiled.getGateCount();
+    projected.assign(gateCount, 0);
+    evaluatedAt.assign(gateCount, 0);
+    lastClock.assign(gateCount, 0);
+    transitions.clear();
+
+    for (auto& partition : partitions) {
+        partition->wheel.reset(0);
+        partition->states.assign(gateCount, 0);
+        for (auto& outbox : partition->outbox) outbox.clear();
+        partition->transitions.clear();
+        partition->pass = 0;
+        partition->lastEventTime = 0;
+        partition->eventCount = 0;
+    }
+
+    for (size_t gate = 0; gate < gateCount; ++gate) {
+        if (CompiledCircuit::isSource(compiled.getType(gate))) continue;
+
+        uint8_t value = compiled.evaluateAt(gate, partitions[owner[gate]]->states);
+        if (value == projected[gate]) continue;
+
+        projected[gate] = value;
+        send(owner[gate], {delays[gate], static_cast<uint32_t>(gate), value});
+    }
+}
+
+void PartitionedTimingSimulator::setInput(size_t gateIndex, bool value, uint64_t time) {
+    if (gateIndex >= owner.size()) return;
+    if (compiled.getType(gateIndex) != GateType::INPUT && compiled.getType(gateIndex) != GateType::CLOCK) return;
+
+    projected[gateIndex] = value;
+    send(owner[gateIndex], {std::max(time, getTime()), static_cast<uint32_t>(gateIndex), static_cast<uint8_t>(value)});
+}
+
+void PartitionedTimingSimulator::send(uint32_t region, const TimingEvent& event) {
+    Partition& partition = *partitions[region];
+    partition.wheel.schedule(event);
+    for (uint32_t k = remoteOffsets[event.gate]; k < remoteOffsets[event.gate + 1]; ++k) {
+        partition.outbox[remoteRegions[k]].push_back(event);
+    }
+}
+
+bool PartitionedTimingSimulator::run(uint64_t until) {
+    const size_t workers = partitions.size();
+    SpinBarrier barrier(workers);
+    if (workers == 1) {
+        runWorker(0, until, barrier);
+    } else {
+        // One task per worker: every task must be running for the barriers
+        // to open, and the pool never runs two tasks on one worker at once.
+        for (uint32_t region = 0; region < workers; ++region) {
+            pool.submit([this, region, until, &barrier] { runWorker(region, until, barrier); });
+        }
+        pool.wait();
+    }
+
+    const size_t before = transitions.size();
+    for (auto& partition : partitions) {
+        transitions.insert(transitions.end(), partition->transitions.begin(), partition->transitions.end());
+        partition->transitions.clear();
+    }
+    std::stable_sort(transitions.begin() + before, transitions.end(),
+                     [](const TimingEvent& a, const TimingEvent& b) { return a.time < b.time; });
+    return isQuiescent();
+}
+
+void PartitionedTimingSimulator::runWorker(uint32_t region, uint64_t until, SpinBarrier& barrier) {
+    Partition& partition = *partitions[region];
+
+    while (true) {
+        for (auto& other : partitions) {
+            for (const TimingEvent& event : other->outbox[region]) partition.wheel.schedule(event);
+            other->outbox[region].clear();
+        }
+        partition.nextTime = partition.wheel.nextTime();
+        barrier.arriveAndWait();
+
+        uint64_t start = UINT64_MAX;
+        for (const auto& other : partitions) start = std::min(start, other->nextTime);
+        if (start > until) break;
+
+        // Events made in this window are due at start + lookahead or later.
+        const uint64_t end = lookahead - 1 > until - start ? until : start + lookahead - 1;
+        partition.due.clear();
+        while (partition.wheel.popDue(partition.due, end)) {
+            processDue(region, partition.wheel.getTime());
+            partition.due.clear();
+        }
+        barrier.arriveAndWait();
+    }
+}
+
+void PartitionedTimingSimulator::processDue(uint32_t region, uint64_t time) {
+    Partition& partition = *partitions[region];
+    ++partition.pass;
+    partition.touched.clear();
+
+    for (const TimingEvent& event : partition.due) {
+        if (partition.states[event.gate] == event.value) continue;
+
+        partition.states[event.gate] = event.value;
+        if (owner[event.gate] == region) {
+            partition.lastEventTime = time;
+            ++partition.eventCount;
+            if (watched[event.gate]) partition.transitions.push_back(event);
+        }
+
+        for (const size_t* it = compiled.fanOutBegin(event.gate); it != compiled.fanOutEnd(event.gate); ++it) {
+            const GateType type = compiled.getType(*it);
+            if (owner[*it] != region || evaluatedAt[*it] == partition.pass || type == GateType::INPUT || type == GateType::CLOCK) continue;
+            evaluatedAt[*it] = partition.pass;
+            partition.touched.push_back(*it);
+        }
+    }
+
+    for (size_t gate : partition.touched) {
+        uint8_t value = compiled.getType(gate) == GateType::DFF ? evaluateRegister(partition, gate) : compiled.evaluateAt(gate, partition.states);
+        if (value == projected[gate]) continue;
+
+        projected[gate] = value;
+        send(region, {time + delays[gate], static_cast<uint32_t>(gate), value});
+    }
+}
+
+uint8_t PartitionedTimingSimulator::evaluateRegister(Partition& partition, size_t gate) {
+    const size_t clk = compiled.getPinSource(gate, 1);
+    const uint8_t level = clk != SIZE_MAX && partition.states[clk];
+    const bool rising = level && !lastClock[gate];
+    lastClock[gate] = level;
+    if (!rising) return projected[gate];
+
+    const size_t d = compiled.getPinSource(gate, 0);
+    return d != SIZE_MAX && partition.states[d];
+}
+
+uint64_t PartitionedTimingSimulator::getTime() const {
+    uint64_t time = 0;
+    for (const auto& partition : partitions) time = std::max(time, partition->wheel.getTime());
+    return time;
+}
+
+uint64_t PartitionedTimingSimulator::getLastEventTime() const {
+    uint64_t time = 0;
+    for (const auto& partition : partitions) time = std::max(time, partition->lastEventTime);
+    return time;
+}
+
+size_t PartitionedTimingSimulator::getEventCount() const {
+    size_t count = 0;
+    for (const auto& partition : partitions) count += partition->eventCount;
+    return count;
+}
+
+bool PartitionedTimingSimulator::isQuiescent() const {
+    for (const auto& partition : partitions) {
+        if (!partition->wheel.empty()) return false;
+        for (const auto& outbox : partition->outbox) {
+            if (!outbox.empty()) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "CompiledCircuit.hpp"
+#include "Netlist.hpp"
+#include "SpinBarrier.hpp"
+#include "ThreadPool.hpp"
+#include "TimingWheel.hpp"
+
+// TimingSimulator split across threads. The gates are partitioned into one
+// region per thread, cutting as few wires as a greedy min-cut refinement
+// finds, and every region runs its own timing wheel. A region keeps copies of
+// the remote gates it reads; their events reach it through per-region
+// outboxes. Simulation advances in windows as long as the smallest delay of
+// a gate that drives another region (the lookahead), so no event made inside
+// a window is due inside it elsewhere, and outboxes are handed over at the
+// barrier between windows. Zero-delay gates are kept in the region of their
+// loads, so the lookahead is at least one tick. Results match
+// TimingSimulator exactly.
+class PartitionedTimingSimulator {
+   private:
+    struct Partition {
+        TimingWheel wheel;
+        // Own gates and copies of the remote drivers of own gates.
+        std::vector<uint8_t> states;
+        std::vector<TimingEvent> due;
+        std::vector<size_t> touched;
+        // Events for copies held by each other region, made this window.
+        std::vector<std::vector<TimingEvent>> outbox;
+        std::vector<TimingEvent> transitions;
+        uint64_t pass = 0;
+        uint64_t nextTime = UINT64_MAX;
+        uint64_t lastEventTime = 0;
+        size_t eventCount = 0;
+    };
+
+    CompiledCircuit compiled;
+    std::vector<uint32_t> delays;
+    std::vector<uint8_t> projected;
+    std::vector<uint8_t> watched;
+    std::vector<uint8_t> lastClock;
+    std::vector<uint64_t> evaluatedAt;
+
+    ThreadPool pool;
+    std::vector<uint32_t> owner;
+    // Regions other than the owner that read gate g:
+    // [remoteOffsets[g], remoteOffsets[g + 1]) of remoteRegions.
+    std::vector<uint32_t> remoteOffsets;
+    std::vector<uint32_t> remoteRegions;
+    std::vector<std::unique_ptr<Partition>> partitions;
+    uint64_t lookahead = UINT64_MAX;
+    size_t cutWires = 0;
+    std::vector<TimingEvent> transitions;
+
+    void assignPartitions(size_t count);
+    void send(uint32_t region, const TimingEvent& event);
+    void runWorker(uint32_t region, uint64_t until, SpinBarrier& barrier);
+    void processDue(uint32_t region, uint64_t time);
+    uint8_t evaluateRegister(Partition& partition, size_t gate);
+
+   public:
+    // Gate count from which splitting pays for the window barriers.
+    static constexpr size_t MIN_GATES = 1 << 14;
+
+    explicit PartitionedTimingSimulator(const Netlist& netlist, size_t threadCount = 0);
+
+    void reset();
+    void setInput(size_t gateIndex, bool value, uint64_t time);
+    bool run(uint64_t until);
+
+    void watch(size_t gateIndex) { watched[gateIndex] = 1; }
+    const std::vector<TimingEvent>& getTransitions() const { return transitions; }
+    void clearTransitions() { transitions.clear(); }
+
+    bool getState(size_t gateIndex) const { return partitions[owner[gateIndex]]->states[gateIndex]; }
+    uint64_t getTime() const;
+    uint64_t getLastEventTime() const;
+    size_t getEventCount() const;
+    bool isQuiescent() const;
+
+    size_t getPartitionCount() const { return partitions.size(); }
+    size_t getCutWires() const { return cutWires; }
+    uint64_t getLookahead() const { return lookahead; }
+};
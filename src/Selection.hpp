@@ -1,29 +1,29 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <algorithm>
-#include <limits>
 #include <vector>
 
 #include "Circuit.hpp"
 
 class Selection {
    private:
-    size_t selectedGate = std::numeric_limits<size_t>::max();
+    GateHandle selectedGate;
     int selectedPin = -1;
     bool selectingSource = true;
-    std::vector<size_t> selectedGates;
+    std::vector<GateHandle> selectedGates;
 
    public:
-    size_t getSelectedGate() const { return selectedGate; }
-    void setSelectedGate(size_t g) { selectedGate = g; }
+    GateHandle getSelectedGate() const { return selectedGate; }
+    bool hasSelectedGate() const { return selectedGate != GateHandle{}; }
+    void setSelectedGate(GateHandle g) { selectedGate = g; }
     int getSelectedPin() const { return selectedPin; }
     void setSelectedPin(int p) { selectedPin = p; }
     bool isSelectingSource() const { return selectingSource; }
     void setSelectingSource(bool s) { selectingSource = s; }
-    const std::vector<size_t>& getSelectedGates() const { return selectedGates; }
+    const std::vector<GateHandle>& getSelectedGates() const { return selectedGates; }
 
     void cancelSelection(Circuit& circuit) {
-        selectedGate = std::numeric_limits<size_t>::max();
+        selectedGate = GateHandle{};
         selectedPin = -1;
         selectingSource = true;
         selectedGates.clear();
@@ -31,36 +31,25 @@ class Selection {
     }
 
     void selectGateAt(sf::Vector2f worldPos, Circuit& circuit) {
-        for (size_t i = 0; i < circuit.getGates().size(); ++i) {
-            if (circuit.getGates()[i].getBounds().contains(worldPos)) {
-                circuit.getGates()[i].setSelected(true);
-                if (std::find(selectedGates.begin(), selectedGates.end(), i) == selectedGates.end()) {
-                    selectedGates.push_back(i);
+        for (size_t i = 0; i < circuit.getSlotCount(); ++i) {
+            if (circuit.hasGate(i) && circuit.getGate(i).getBounds().contains(worldPos)) {
+                circuit.getGate(i).setSelected(true);
+                const GateHandle handle = circuit.getGateHandle(i);
+                if (std::find(selectedGates.begin(), selectedGates.end(), handle) == selectedGates.end()) {
+                    selectedGates.push_back(handle);
                 }
                 break;
             }
         }
     }
 
+    // Handles never go stale silently, so gates removed in the meantime are
+    // skipped and no index needs adjusting between removals.
     void deleteSelectedGates(Circuit& circuit) {
-        if (selectedGates.empty()) return;
-
-        std::sort(selectedGates.begin(), selectedGates.end());
-        selectedGates.erase(std::unique(selectedGates.begin(), selectedGates.end()), selectedGates.end());
-        std::sort(selectedGates.begin(), selectedGates.end(), std::greater<size_t>());
-
-        std::vector<size_t> validIndices;
-        for (size_t gateIndex : selectedGates) {
-            if (gateIndex < circuit.getGates().size()) {
-                validIndices.push_back(gateIndex);
-            }
+        for (GateHandle handle : selectedGates) {
+            if (circuit.isValid(handle)) circuit.removeGate(handle);
         }
-
-        for (size_t gateIndex : validIndices) {
-            circuit.removeWiresConnectedToGate(gateIndex);
-            circuit.removeGate(gateIndex);
-        }
-
+        if (!circuit.isValid(selectedGate)) selectedGate = GateHandle{};
         selectedGates.clear();
     }
 };
\ No newline at end of file
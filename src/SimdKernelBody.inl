@@ -0,0 +1,48 @@
+// Shared body of the block kernels. Included once per instruction set by
+// SimdKernels.cpp after Lane, LANE_WORDS and the lane helpers are defined.
+
+#define FOR_EACH_LANE(expr)                                             \
+    for (size_t w = 0; w < SimdKernels::BLOCK_WORDS; w += LANE_WORDS) { \
+        storeLane(d + w, expr);                                         \
+    }
+
+static void evaluateBlock(const WordOp* ops, size_t opCount, uint64_t* nets) {
+    for (size_t i = 0; i < opCount; ++i) {
+        const WordOp& op = ops[i];
+        uint64_t* d = nets + static_cast<size_t>(op.dst) * SimdKernels::BLOCK_WORDS;
+        const uint64_t* a = nets + static_cast<size_t>(op.a) * SimdKernels::BLOCK_WORDS;
+        const uint64_t* b = nets + static_cast<size_t>(op.b) * SimdKernels::BLOCK_WORDS;
+
+        switch (op.code) {
+            case WordOpCode::ZERO:
+                FOR_EACH_LANE(zeroLane());
+                break;
+            case WordOpCode::ONES:
+                FOR_EACH_LANE(onesLane());
+                break;
+            case WordOpCode::COPY:
+                FOR_EACH_LANE(loadLane(a + w));
+                break;
+            case WordOpCode::NOT:
+                FOR_EACH_LANE(notLane(loadLane(a + w)));
+                break;
+            case WordOpCode::AND:
+                FOR_EACH_LANE(andLane(loadLane(a + w), loadLane(b + w)));
+                break;
+            case WordOpCode::OR:
+                FOR_EACH_LANE(orLane(loadLane(a + w), loadLane(b + w)));
+                break;
+            case WordOpCode::XOR:
+                FOR_EACH_LANE(xorLane(loadLane(a + w), loadLane(b + w)));
+                break;
+            case WordOpCode::NAND:
+                FOR_EACH_LANE(notLane(andLane(loadLane(a + w), loadLane(b + w))));
+                break;
+            case WordOpCode::NOR:
+                FOR_EACH_LANE(notLane(orLane(loadLane(a + w), loadLane(b + w))));
+                break;
+        }
+    }
+}
+
+#undef FOR_EACH_LANE
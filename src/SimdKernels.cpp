@@ -0,0 +1,94 @@
+#include "SimdKernels.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace scalar {
+using Lane = uint64_t;
+constexpr size_t LANE_WORDS = 1;
+static inline Lane loadLane(const uint64_t* p) { return *p; }
+static inline void storeLane(uint64_t* p, Lane v) { *p = v; }
+static inline Lane zeroLane() { return 0; }
+static inline Lane onesLane() { return ~0ULL; }
+static inline Lane notLane(Lane a) { return ~a; }
+static inline Lane andLane(Lane a, Lane b) { return a & b; }
+static inline Lane orLane(Lane a, Lane b) { return a | b; }
+static inline Lane xorLane(Lane a, Lane b) { return a ^ b; }
+#include "SimdKernelBody.inl"
+}  // namespace scalar
+
+#ifdef SIMD_KERNELS_X86
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+using Lane = __m256i;
+constexpr size_t LANE_WORDS = 4;
+static inline Lane loadLane(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+static inline void storeLane(uint64_t* p, Lane v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+static inline Lane zeroLane() { return _mm256_setzero_si256(); }
+static inline Lane onesLane() { return _mm256_set1_epi64x(-1); }
+static inline Lane notLane(Lane a) { return _mm256_xor_si256(a, onesLane()); }
+static inline Lane andLane(Lane a, Lane b) { return _mm256_and_si256(a, b); }
+static inline Lane orLane(Lane a, Lane b) { return _mm256_or_si256(a, b); }
+static inline Lane xorLane(Lane a, Lane b) { return _mm256_xor_si256(a, b); }
+#include "SimdKernelBody.inl"
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+namespace avx512 {
+using Lane = __m512i;
+constexpr size_t LANE_WORDS = 8;
+static inline Lane loadLane(const uint64_t* p) { return _mm512_loadu_si512(p); }
+static inline void storeLane(uint64_t* p, Lane v) { _mm512_storeu_si512(p, v); }
+static inline Lane zeroLane() { return _mm512_setzero_si512(); }
+static inline Lane onesLane() { return _mm512_set1_epi64(-1); }
+static inline Lane notLane(Lane a) { return _mm512_ternarylogic_epi64(a, a, a, 0x55); }
+static inline Lane andLane(Lane a, Lane b) { return _mm512_and_si512(a, b); }
+static inline Lane orLane(Lane a, Lane b) { return _mm512_or_si512(a, b); }
+static inline Lane xorLane(Lane a, Lane b) { return _mm512_xor_si512(a, b); }
+#include "SimdKernelBody.inl"
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+SimdLevel SimdKernels::detectLevel() {
+#ifdef SIMD_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdKernels::BlockKernel SimdKernels::getKernel(SimdLevel level) {
+    switch (level) {
+#ifdef SIMD_KERNELS_X86
+        case SimdLevel::AVX512:
+            return &avx512::evaluateBlock;
+        case SimdLevel::AVX2:
+            return &avx2::evaluateBlock;
+#endif
+        default:
+            return &scalar::evaluateBlock;
+    }
+}
+
+SimdKernels::BlockKernel SimdKernels::getBestKernel() {
+    static const BlockKernel kernel = getKernel(detectLevel());
+    return kernel;
+}
+
+const char* SimdKernels::getLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512:
+            return "AVX-512";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum class WordOpCode : uint8_t { ZERO, ONES, COPY, NOT, AND, OR, XOR, NAND, NOR };
+
+// One normalized gate operation over net blocks: nets[dst] = code(nets[a], nets[b]).
+struct WordOp {
+    WordOpCode code;
+    uint32_t dst;
+    uint32_t a;
+    uint32_t b;
+};
+
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+// Block kernels evaluate a WordOp program over BLOCK_WORDS words per net
+// (512 input patterns). Nets are stored net-major: net n occupies
+// nets[n * BLOCK_WORDS .. n * BLOCK_WORDS + BLOCK_WORDS).
+class SimdKernels {
+   public:
+    static constexpr size_t BLOCK_WORDS = 8;
+
+    using BlockKernel = void (*)(const WordOp* ops, size_t opCount, uint64_t* nets);
+
+    static SimdLevel detectLevel();
+    static BlockKernel getKernel(SimdLevel level);
+    static BlockKernel getBestKernel();
+    static const char* getLevelName(SimdLevel level);
+};
@@ -7,16 +7,16 @@ int g_selectedPin = -100;
 
 Simulator::Simulator() {}
 
-void Simulator::handleEvent(const sf::Event &event, const sf::RenderWindow &window, const sf::View &view, GateType selectedGateType) {
+void Simulator::handleEvent(const sf::Event &event, const sf::RenderWindow &window, const sf::View &view, GateType selectedGateType, int selectedModule) {
     if (const auto *clicked = event.getIf<sf::Event::MouseButtonPressed>()) {
         if (clicked->button == sf::Mouse::Button::Left) {
             sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
             sf::Vector2i mousePixel = sf::Mouse::getPosition(window);
             sf::Vector2f mousePos{static_cast<float>(mousePixel.x), static_cast<float>(mousePixel.y)};
-            if (ui.getShowExpression()) {
+            if (ui.isAnyExpressionShown()) {
                 sf::FloatRect closeBtn({1110.f, 55.f}, {60.f, 20.f});
                 if (closeBtn.contains(mousePos)) {
-                    ui.setShowExpression(false);
+                    ui.hideExpressions();
                     return;
                 }
             }
@@ -27,13 +27,10 @@ void Simulator::handleEvent(const sf::Event &event, const sf::RenderWindow &wind
                     return;
                 }
             }
-            if (ui.getShowInputField(1) || ui.getShowInputField(2)) {
+            if (ui.isAnyInputFieldShown()) {
                 sf::FloatRect closeBtn({1110.f, 355.f}, {60.f, 20.f});
                 if (closeBtn.contains(mousePos)) {
-                    ui.setShowInputField(false, 1);
-                    ui.setShowInputField(false, 2);
-                    ui.setInputExpression("", 1);
-                    ui.setInputExpression("", 2);
+                    ui.clearInputFields();
                     return;
                 }
             }
@@ -43,29 +40,30 @@ void Simulator::handleEvent(const sf::Event &event, const sf::RenderWindow &wind
             if (mousePos.x >= rightPanelStart) return;
             sf::Vector2f worldPos = window.mapPixelToCoords(mousePixel, view);
             bool hitGate = false;
-            for (size_t i = 0; i < circuit.getGates().size(); ++i) {
-                if (circuit.getGates()[i].getType() != GateType::OUTPUT) {
-                    sf::Vector2f outPin = circuit.getGates()[i].getOutputPinPosition();
+            for (size_t i = 0; i < circuit.getSlotCount(); ++i) {
+                if (!circuit.hasGate(i)) continue;
+                const Gate &gate = circuit.getGate(i);
+                for (int k = 0; k < gate.getOutputPinCount(); ++k) {
+                    sf::Vector2f outPin = gate.getOutputPinPosition(k);
                     if (sf::FloatRect(outPin - sf::Vector2f{8.f, 8.f}, {16.f, 16.f}).contains(worldPos)) {
-                        if (selection.isSelectingSource() && selection.getSelectedGate() == std::numeric_limits<size_t>::max()) {
-                            selection.setSelectedGate(i);
-                            selection.setSelectedPin(-1);
+                        if (selection.isSelectingSource() && !selection.hasSelectedGate()) {
+                            selection.setSelectedGate(circuit.getGateHandle(i));
+                            selection.setSelectedPin(-1 - k);
                             selection.setSelectingSource(false);
                         }
                         hitGate = true;
                         break;
                     }
                 }
-                if (circuit.getGates()[i].getType() != GateType::INPUT) {
-                    int inputCount =
-                        (circuit.getGates()[i].getType() == GateType::NOT || circuit.getGates()[i].getType() == GateType::OUTPUT) ? 1 : 2;
+                if (hitGate) break;
+                if (gate.getInputPinCount() > 0) {
+                    int inputCount = gate.getInputPinCount();
                     for (int j = 0; j < inputCount; ++j) {
-                        sf::Vector2f inPin = circuit.getGates()[i].getInputPinPosition(j);
+                        sf::Vector2f inPin = gate.getInputPinPosition(j);
                         if (sf::FloatRect(inPin - sf::Vector2f{8.f, 8.f}, {16.f, 16.f}).contains(worldPos)) {
-                            if (!selection.isSelectingSource() && selection.getSelectedGate() != std::numeric_limits<size_t>::max() &&
-                                selection.getSelectedGate() < circuit.getGates().size()) {
-                                circuit.addWire(selection.getSelectedGate(), selection.getSelectedPin(), i, j);
-                                selection.setSelectedGate(std::numeric_limits<size_t>::max());
+                            if (!selection.isSelectingSource() && circuit.isValid(selection.getSelectedGate())) {
+                                circuit.addWire(selection.getSelectedGate().index, selection.getSelectedPin(), i, j);
+                                selection.setSelectedGate(GateHandle{});
                                 selection.setSelectedPin(-1);
                                 selection.setSelectingSource(true);
                             }
@@ -75,23 +73,27 @@ void Simulator::handleEvent(const sf::Event &event, const sf::RenderWindow &wind
                     }
                     if (hitGate) break;
                 }
-                if (circuit.getGates()[i].getBounds().contains(worldPos)) {
-                    if (circuit.getGates()[i].getType() == GateType::INPUT) {
-                        circuit.getGates()[i].setState(!circuit.getGates()[i].getState());
+                if (gate.getBounds().contains(worldPos)) {
+                    if (gate.getType() == GateType::INPUT) {
+                        circuit.setInputState(i, !circuit.getState(i));
                     }
                     selection.selectGateAt(worldPos, circuit);
                     hitGate = true;
                     break;
                 }
             }
-            if (!hitGate && selection.getSelectedGate() == std::numeric_limits<size_t>::max()) {
-                circuit.addGate(selectedGateType, worldPos);
+            if (!hitGate && !selection.hasSelectedGate()) {
+                if (selectedGateType == GateType::MODULE) {
+                    if (selectedModule >= 0) circuit.addModule(selectedModule, worldPos);
+                } else {
+                    circuit.addGate(selectedGateType, worldPos);
+                }
             }
         } else if (clicked->button == sf::Mouse::Button::Right) {
             selection.cancelSelection(circuit);
         }
     }
-    if (ui.getShowInputField(1) || ui.getShowInputField(2)) {
+    if (ui.isAnyInputFieldShown()) {
         if (const auto *textEntered = event.getIf<sf::Event::TextEntered>()) {
             if (textEntered->unicode < 128) {
                 char c = static_cast<char>(textEntered->unicode);
@@ -118,26 +120,35 @@ void Simulator::handleEvent(const sf::Event &event, const sf::RenderWindow &wind
 }
 
 void Simulator::update() {
-    circuit.updateWirePositions();
+    if (clockTimer.getElapsedTime() >= sf::milliseconds(CLOCK_HALF_PERIOD_MS)) {
+        clockTimer.restart();
+        for (size_t i = 0; i < circuit.getSlotCount(); ++i) {
+            if (circuit.hasGate(i) && circuit.getGate(i).getType() == GateType::CLOCK) {
+                circuit.setInputState(i, !circuit.getState(i));
+            }
+        }
+    }
+
     circuit.evaluateCircuit();
 
     ui.updateFromCircuit(circuit);
 }
 
 void Simulator::draw(sf::RenderWindow &window) const {
-    g_selectedGate = (int)selection.getSelectedGate();
+    g_selectedGate = selection.hasSelectedGate() ? (int)selection.getSelectedGate().index : -1;
     g_selectedPin = selection.getSelectedPin();
     circuit.drawAllGates(window);
     g_selectedGate = -1;
     g_selectedPin = -100;
-    for (const auto &wire : circuit.getWires()) {
-        wire.draw(window);
+    const SlotMap<Net> &nets = circuit.getNets();
+    for (size_t i = 0; i < nets.slotCount(); ++i) {
+        if (nets.contains(i)) nets[i].draw(window);
     }
 }
 
 void Simulator::drawUI(sf::RenderWindow &window) const { ui.drawUI(window); }
 
-void Simulator::generateTruthTable() { ui.updateFromCircuit(circuit); }
+void Simulator::generateTruthTable() { ui.updateFromCircuit(circuit, true); }
 
 void Simulator::generateLogicalExpression() {
     UIManager ui;
@@ -151,6 +162,25 @@ void Simulator::clearCircuit() {
 
 void Simulator::deleteSelectedGates() { selection.deleteSelectedGates(circuit); }
 
+void Simulator::changeInputCount(int delta) {
+    // '+' and '-' are expression characters while an input field is open.
+    if (ui.isAnyInputFieldShown()) return;
+
+    for (GateHandle handle : selection.getSelectedGates()) {
+        if (circuit.isValid(handle)) circuit.setGateInputCount(handle.index, circuit.getGate(handle.index).getInputPinCount() + delta);
+    }
+}
+
+int Simulator::packageSelection() {
+    // 'm' is an expression character while an input field is open.
+    if (ui.isAnyInputFieldShown()) return -1;
+
+    const std::string name = "M" + std::to_string(circuit.getModuleLibrary().size() + 1);
+    const int definition = circuit.defineModule(name, selection.getSelectedGates());
+    if (definition >= 0) selection.cancelSelection(circuit);
+    return definition;
+}
+
 void Simulator::cancelSelection() { selection.cancelSelection(circuit); }
 
 void Simulator::setFont(const sf::Font &font) {
@@ -158,4 +188,4 @@ void Simulator::setFont(const sf::Font &font) {
     circuit.setFont(font);
 }
 
-void Simulator::generateExpressionTruthTable() { ui.updateFromCircuit(circuit); }
\ No newline at end of file
+void Simulator::generateExpressionTruthTable() { ui.updateFromCircuit(circuit, true); }
\ No newline at end of file
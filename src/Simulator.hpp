@@ -10,10 +10,14 @@ class Simulator {
     Circuit circuit;
     Selection selection;
     UIManager ui;
+    sf::Clock clockTimer;
+
+    static constexpr int CLOCK_HALF_PERIOD_MS = 500;
 
    public:
     Simulator();
-    void handleEvent(const sf::Event &event, const sf::RenderWindow &window, const sf::View &view, GateType selectedGateType);
+    // selectedModule is the definition placed when selectedGateType is MODULE.
+    void handleEvent(const sf::Event &event, const sf::RenderWindow &window, const sf::View &view, GateType selectedGateType, int selectedModule);
     void update();
     void draw(sf::RenderWindow &window) const;
     void drawUI(sf::RenderWindow &window) const;
@@ -21,6 +25,12 @@ class Simulator {
     void generateLogicalExpression();
     void clearCircuit();
     void deleteSelectedGates();
+    // Adds delta input pins to every selected multi-input gate.
+    void changeInputCount(int delta);
+    // Turns the selected gates into a new module definition named M1, M2, ...
+    // and returns its id, or -1 if none was made.
+    int packageSelection();
+    const std::string &getModuleName(size_t definition) const { return circuit.getModuleLibrary().getName(definition); }
     void cancelSelection();
     void setFont(const sf::Font &font);
     void generateExpressionTruthTable();
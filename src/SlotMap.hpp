@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Stable reference to a SlotMap entry. The generation is bumped whenever a
+// slot is freed, so a handle to a removed entry never aliases whatever is
+// stored in the slot later.
+struct SlotHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Values stored in slots that never move: inserting reuses the most recently
+// freed slot and erasing leaves a hole, so plain slot indices stay valid for
+// the lifetime of an entry and both operations are O(1). Iterate with
+// slotCount() and contains().
+template <typename T>
+class SlotMap {
+   private:
+    std::vector<std::optional<T>> values;
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeSlots;
+    size_t liveCount = 0;
+
+   public:
+    // Slot the next insert() will use.
+    size_t nextSlot() const { return freeSlots.empty() ? values.size() : freeSlots.back(); }
+
+    SlotHandle insert(T value) {
+        const uint32_t index = static_cast<uint32_t>(nextSlot());
+        if (freeSlots.empty()) {
+            values.emplace_back();
+            generations.push_back(0);
+        } else {
+            freeSlots.pop_back();
+        }
+        values[index].emplace(std::move(value));
+        ++liveCount;
+        return {index, generations[index]};
+    }
+
+    bool erase(size_t index) {
+        if (!contains(index)) return false;
+        values[index].reset();
+        ++generations[index];
+        freeSlots.push_back(static_cast<uint32_t>(index));
+        --liveCount;
+        return true;
+    }
+    bool erase(SlotHandle handle) { return contains(handle) && erase(handle.index); }
+
+    void clear() {
+        values.clear();
+        generations.clear();
+        freeSlots.clear();
+        liveCount = 0;
+    }
+
+    bool contains(size_t index) const { return index < values.size() && values[index].has_value(); }
+    bool contains(SlotHandle handle) const { return contains(handle.index) && generations[handle.index] == handle.generation; }
+
+    SlotHandle handleAt(size_t index) const {
+        if (!contains(index)) return {};
+        return {static_cast<uint32_t>(index), generations[index]};
+    }
+
+    T& operator[](size_t index) { return *values[index]; }
+    const T& operator[](size_t index) const { return *values[index]; }
+    T* get(SlotHandle handle) { return contains(handle) ? &*values[handle.index] : nullptr; }
+    const T* get(SlotHandle handle) const { return contains(handle) ? &*values[handle.index] : nullptr; }
+
+    size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+    // One past the highest slot ever used; live entries are below it.
+    size_t slotCount() const { return values.size(); }
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+// Generation-counting barrier for a fixed number of threads. Phases between
+// barriers are short, so waiting threads spin and yield instead of sleeping
+// on a condition variable. Everything written before arriveAndWait() is
+// visible to every thread once it returns.
+class SpinBarrier {
+   private:
+    const size_t participants;
+    std::atomic<size_t> arrived{0};
+    std::atomic<size_t> generation{0};
+
+   public:
+    explicit SpinBarrier(size_t participants) : participants(participants) {}
+
+    void arriveAndWait() {
+        const size_t current = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == participants) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (generation.load(std::memory_order_acquire) == current) std::this_thread::yield();
+    }
+};
@@ -0,0 +1,103 @@
+#include "ThreadPool.hpp"
+
+#include <utility>
+
+namespace {
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t index = (currentPool == this) ? currentWorker : nextQueue.fetch_add(1) % queues.size();
+
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queued.fetch_add(1);
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    idle.wait(lock, [this] { return pending.load() == 0; });
+    if (firstError) std::rethrow_exception(std::exchange(firstError, nullptr));
+}
+
+bool ThreadPool::popLocal(size_t index, std::function<void()>& task) {
+    WorkerQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(size_t index, std::function<void()>& task) {
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkerQueue& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        std::function<void()> task;
+        if (popLocal(index, task) || steal(index, task)) {
+            queued.fetch_sub(1);
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (!firstError) firstError = std::current_exception();
+            }
+
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
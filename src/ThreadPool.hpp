@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool where every worker owns a task deque. Workers pop their
+// own newest task first and steal the oldest task from other workers when
+// they run dry, which keeps uneven chunk costs balanced across cores.
+class ThreadPool {
+   private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> nextQueue{0};
+    bool stopping = false;
+    // First exception thrown by a task since the last wait(); guarded by stateMutex.
+    std::exception_ptr firstError;
+
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, std::function<void()>& task);
+    bool steal(size_t index, std::function<void()>& task);
+
+   public:
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Tasks submitted from a worker go to that worker's own deque; others are
+    // spread round-robin.
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished, then rethrows the
+    // first exception any of them threw. Must not be called from inside a
+    // task.
+    void wait();
+
+    size_t getThreadCount() const { return threads.size(); }
+};
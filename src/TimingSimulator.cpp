@@ -0,0 +1,113 @@
+#include "TimingSimulator.hpp"
+
+TimingSimulator::TimingSimulator(const Netlist& netlist) {
+    compiled.compile(netlist);
+
+    const size_t gateCount = netlist.getGateCount();
+    delays.resize(gateCount);
+    for (size_t i = 0; i < gateCount; ++i) {
+        int delay = netlist.getDelay(i);
+        delays[i] = delay >= 0 ? static_cast<uint32_t>(delay) : getDefaultDelay(netlist.getType(i));
+    }
+
+    watched.assign(gateCount, 0);
+    reset();
+}
+
+uint32_t TimingSimulator::getDefaultDelay(GateType type) {
+    switch (type) {
+        case GateType::NOT:
+        case GateType::NAND:
+        case GateType::NOR:
+            return 1;
+        case GateType::AND:
+        case GateType::OR:
+        case GateType::DFF:
+        case GateType::LATCH:
+            return 2;
+        case GateType::XOR:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+void TimingSimulator::reset() {
+    const size_t gateCount = compiled.getGateCount();
+    states.assign(gateCount, 0);
+    projected.assign(gateCount, 0);
+    evaluatedAt.assign(gateCount, 0);
+    lastClock.assign(gateCount, 0);
+    pass = 0;
+    wheel.reset(0);
+    transitions.clear();
+    lastEventTime = 0;
+    eventCount = 0;
+
+    for (size_t gate = 0; gate < gateCount; ++gate) {
+        if (CompiledCircuit::isSource(compiled.getType(gate))) continue;
+
+        uint8_t value = compiled.evaluateAt(gate, states);
+        if (value == projected[gate]) continue;
+
+        projected[gate] = value;
+        wheel.schedule({delays[gate], static_cast<uint32_t>(gate), value});
+    }
+}
+
+void TimingSimulator::setInput(size_t gateIndex, bool value, uint64_t time) {
+    if (gateIndex >= states.size()) return;
+    if (compiled.getType(gateIndex) != GateType::INPUT && compiled.getType(gateIndex) != GateType::CLOCK) return;
+
+    projected[gateIndex] = value;
+    wheel.schedule({time, static_cast<uint32_t>(gateIndex), static_cast<uint8_t>(value)});
+}
+
+bool TimingSimulator::run(uint64_t until) {
+    due.clear();
+    while (wheel.popDue(due, until)) {
+        processDue(wheel.getTime());
+        due.clear();
+    }
+    return wheel.empty();
+}
+
+void TimingSimulator::processDue(uint64_t time) {
+    ++pass;
+    touched.clear();
+
+    for (const TimingEvent& event : due) {
+        if (states[event.gate] == event.value) continue;
+
+        states[event.gate] = event.value;
+        lastEventTime = time;
+        ++eventCount;
+        if (watched[event.gate]) transitions.push_back(event);
+
+        for (const size_t* it = compiled.fanOutBegin(event.gate); it != compiled.fanOutEnd(event.gate); ++it) {
+            const GateType type = compiled.getType(*it);
+            if (evaluatedAt[*it] == pass || type == GateType::INPUT || type == GateType::CLOCK) continue;
+            evaluatedAt[*it] = pass;
+            touched.push_back(*it);
+        }
+    }
+
+    for (size_t gate : touched) {
+        uint8_t value = compiled.getType(gate) == GateType::DFF ? evaluateRegister(gate) : compiled.evaluateAt(gate, states);
+        if (value == projected[gate]) continue;
+
+        projected[gate] = value;
+        wheel.schedule({time + delays[gate], static_cast<uint32_t>(gate), value});
+    }
+}
+
+uint8_t TimingSimulator::evaluateRegister(size_t gate) {
+    const size_t clk = compiled.getPinSource(gate, 1);
+    const uint8_t level = clk != SIZE_MAX && states[clk];
+    const bool rising = level && !lastClock[gate];
+    lastClock[gate] = level;
+    if (!rising) return projected[gate];
+
+    const size_t d = compiled.getPinSource(gate, 0);
+    return d != SIZE_MAX && states[d];
+}
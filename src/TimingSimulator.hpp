@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "CompiledCircuit.hpp"
+#include "Netlist.hpp"
+#include "TimingWheel.hpp"
+
+// Discrete-event simulation with per-gate propagation delays. A gate whose
+// inputs change is re-evaluated and, if its projected output differs, an
+// output event is scheduled delay ticks later (transport delay), so short
+// pulses and glitches propagate instead of being hidden by a fixed point.
+// Feedback loops need no special handling; oscillators simply keep
+// producing events until the run limit. A DFF only schedules a new output
+// when its CLK pin is seen rising.
+class TimingSimulator {
+   private:
+    CompiledCircuit compiled;
+    std::vector<uint32_t> delays;
+    std::vector<uint8_t> states;
+    std::vector<uint8_t> projected;
+    std::vector<uint8_t> watched;
+    std::vector<uint8_t> lastClock;
+    std::vector<uint64_t> evaluatedAt;
+    uint64_t pass = 0;
+
+    TimingWheel wheel;
+    std::vector<TimingEvent> due;
+    std::vector<size_t> touched;
+    std::vector<TimingEvent> transitions;
+    uint64_t lastEventTime = 0;
+    size_t eventCount = 0;
+
+    void processDue(uint64_t time);
+    uint8_t evaluateRegister(size_t gate);
+
+   public:
+    explicit TimingSimulator(const Netlist& netlist);
+
+    static uint32_t getDefaultDelay(GateType type);
+
+    // Puts every gate at 0 and schedules the initial settling from time 0.
+    void reset();
+
+    // Schedules an INPUT or CLOCK change. Times before getTime() are clamped to it.
+    void setInput(size_t gateIndex, bool value, uint64_t time);
+
+    // Processes every event up to and including time until. Returns true if
+    // the circuit is quiescent afterwards.
+    bool run(uint64_t until);
+
+    // Records transitions of this gate in getTransitions().
+    void watch(size_t gateIndex) { watched[gateIndex] = 1; }
+    const std::vector<TimingEvent>& getTransitions() const { return transitions; }
+    void clearTransitions() { transitions.clear(); }
+
+    bool getState(size_t gateIndex) const { return states[gateIndex]; }
+    uint64_t getTime() const { return wheel.getTime(); }
+    uint64_t getLastEventTime() const { return lastEventTime; }
+    size_t getEventCount() const { return eventCount; }
+    bool isQuiescent() const { return wheel.empty(); }
+};
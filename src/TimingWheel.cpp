@@ -0,0 +1,132 @@
+#include "TimingWheel.hpp"
+
+#include <algorithm>
+
+TimingWheel::TimingWheel() : slots(LEVELS * SLOTS) {}
+
+void TimingWheel::reset(uint64_t time) {
+    for (auto& bucket : slots) bucket.clear();
+    std::fill(std::begin(counts), std::end(counts), 0);
+    overflow.clear();
+    now = time;
+    pending = 0;
+}
+
+void TimingWheel::insert(const TimingEvent& event) {
+    const uint64_t diff = event.time ^ now;
+    for (int level = 0; level < LEVELS; ++level) {
+        const int shift = SLOT_BITS * (level + 1);
+        if (shift >= 64 || (diff >> shift) == 0) {
+            slot(level, (event.time >> (SLOT_BITS * level)) & SLOT_MASK).push_back(event);
+            ++counts[level];
+            return;
+        }
+    }
+    overflow.push_back(event);
+}
+
+void TimingWheel::schedule(const TimingEvent& event) {
+    TimingEvent clamped = event;
+    if (clamped.time < now) clamped.time = now;
+    insert(clamped);
+    ++pending;
+}
+
+void TimingWheel::cascade(int level, uint64_t index) {
+    std::vector<TimingEvent> moved;
+    moved.swap(slot(level, index));
+    counts[level] -= moved.size();
+    for (const TimingEvent& event : moved) {
+        insert(event);
+    }
+}
+
+bool TimingWheel::popDue(std::vector<TimingEvent>& out, uint64_t limit) {
+    if (pending == 0) return false;
+
+    while (true) {
+        // Every level-0 event shares the current 256-tick window and is not
+        // in the past, so the first non-empty bucket from here is the next time.
+        if (counts[0] > 0) {
+            for (uint64_t index = now & SLOT_MASK; index < SLOTS; ++index) {
+                std::vector<TimingEvent>& bucket = slot(0, index);
+                if (bucket.empty()) continue;
+
+                const uint64_t time = (now & ~SLOT_MASK) | index;
+                if (time > limit) return false;
+
+                now = time;
+                out.insert(out.end(), bucket.begin(), bucket.end());
+                counts[0] -= bucket.size();
+                pending -= bucket.size();
+                bucket.clear();
+                return true;
+            }
+        }
+
+        // Jump straight to the next occupied bucket of the lowest non-empty
+        // level and pull it down.
+        bool advanced = false;
+        for (int level = 1; level < LEVELS && !advanced; ++level) {
+            if (counts[level] == 0) continue;
+
+            const int shift = SLOT_BITS * level;
+            for (uint64_t index = ((now >> shift) & SLOT_MASK) + 1; index < SLOTS; ++index) {
+                if (slot(level, index).empty()) continue;
+
+                const uint64_t upper = shift + SLOT_BITS >= 64 ? 0 : (now >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+                const uint64_t bucketStart = upper | (index << shift);
+                if (bucketStart > limit) return false;
+
+                now = bucketStart;
+                cascade(level, index);
+                advanced = true;
+                break;
+            }
+        }
+        if (advanced) continue;
+
+        // Only far-future events remain.
+        if (overflow.empty()) return false;
+        uint64_t earliest = overflow.front().time;
+        for (const TimingEvent& event : overflow) earliest = std::min(earliest, event.time);
+        if (earliest > limit) return false;
+
+        now = earliest;
+        std::vector<TimingEvent> moved;
+        moved.swap(overflow);
+        for (const TimingEvent& event : moved) {
+            insert(event);
+        }
+    }
+}
+
+uint64_t TimingWheel::nextTime() const {
+    if (pending == 0) return UINT64_MAX;
+
+    // Same search order as popDue(): every event of a lower level comes
+    // before any event of a higher one.
+    if (counts[0] > 0) {
+        for (uint64_t index = now & SLOT_MASK; index < SLOTS; ++index) {
+            if (!slot(0, index).empty()) return (now & ~SLOT_MASK) | index;
+        }
+    }
+
+    for (int level = 1; level < LEVELS; ++level) {
+        if (counts[level] == 0) continue;
+
+        const int shift = SLOT_BITS * level;
+        for (uint64_t index = ((now >> shift) & SLOT_MASK) + 1; index < SLOTS; ++index) {
+            const std::vector<TimingEvent>& bucket = slot(level, index);
+            if (bucket.empty()) continue;
+
+            uint64_t earliest = bucket.front().time;
+            for (const TimingEvent& event : bucket) earliest = std::min(earliest, event.time);
+            return earliest;
+        }
+    }
+
+    uint64_t earliest = UINT64_MAX;
+    for (const TimingEvent& event : overflow) earliest = std::min(earliest, event.time);
+    return earliest;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TimingEvent {
+    uint64_t time;
+    uint32_t gate;
+    uint8_t value;
+};
+
+// Hierarchical timing wheel: LEVELS wheels of SLOTS buckets, level L covering
+// times that agree with the current time above bit SLOT_BITS * (L + 1).
+// Insertion is O(1); events far in the future ride in a higher level and are
+// cascaded down once the wheel reaches their bucket, so popping is O(1)
+// amortized. Times beyond the top level wait in an overflow list.
+class TimingWheel {
+   private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    std::vector<std::vector<TimingEvent>> slots;
+    size_t counts[LEVELS] = {};
+    std::vector<TimingEvent> overflow;
+    uint64_t now = 0;
+    size_t pending = 0;
+
+    std::vector<TimingEvent>& slot(int level, uint64_t index) { return slots[level * SLOTS + index]; }
+    const std::vector<TimingEvent>& slot(int level, uint64_t index) const { return slots[level * SLOTS + index]; }
+    void insert(const TimingEvent& event);
+    void cascade(int level, uint64_t index);
+
+   public:
+    TimingWheel();
+
+    // Events in the past are clamped to the current time.
+    void schedule(const TimingEvent& event);
+
+    // Advances to the earliest pending time and appends every event due at
+    // that time to out. Returns false, without advancing past limit, when
+    // nothing is pending at or before limit.
+    bool popDue(std::vector<TimingEvent>& out, uint64_t limit = UINT64_MAX);
+
+    // Time of the earliest pending event without advancing, or UINT64_MAX.
+    uint64_t nextTime() const;
+
+    void reset(uint64_t time = 0);
+    uint64_t getTime() const { return now; }
+    size_t size() const { return pending; }
+    bool empty() const { return pending == 0; }
+};
@@ -5,11 +5,14 @@
 
 #include "Circuit.hpp"
 #include "ExpressionSimplifier.hpp"
+#include "Netlist.hpp"
 
 class GridConfig {
    public:
     static constexpr int GRID_ROWS = 12;
     static constexpr int GRID_COLS = 4;
+    // Rows taken by the expression list; the truth table gets the rest.
+    static constexpr int EXPRESSION_ROWS = 4;
     static constexpr float GRID_PADDING = 10.f;
     static constexpr float GRID_MARGIN = 15.f;
 
@@ -116,31 +119,15 @@ void UIManager::setupBackgrounds() const {
         rightPanelBg = createBackground({0.f, 0.f}, panelSize, sf::Color(240, 240, 240, 200));
     }
 
-    if (!inputFieldBg1) {
+    if (!expressionBg) {
         sf::Vector2f position = GridConfig::getGridPosition(0, 0);
-        sf::Vector2f size = GridConfig::getGridAreaSize(1, 4);
-        inputFieldBg1 = createBackground(position, size, sf::Color(255, 240, 240, 220));
-    }
-    if (!expressionBg1) {
-        sf::Vector2f position = GridConfig::getGridPosition(1, 0);
-        sf::Vector2f size = GridConfig::getGridAreaSize(1, 4);
-        expressionBg1 = createBackground(position, size, sf::Color(240, 255, 240, 220));
-    }
-
-    if (!inputFieldBg2) {
-        sf::Vector2f position = GridConfig::getGridPosition(2, 0);
-        sf::Vector2f size = GridConfig::getGridAreaSize(1, 4);
-        inputFieldBg2 = createBackground(position, size, sf::Color(255, 255, 240, 220));
-    }
-    if (!expressionBg2) {
-        sf::Vector2f position = GridConfig::getGridPosition(3, 0);
-        sf::Vector2f size = GridConfig::getGridAreaSize(1, 4);
-        expressionBg2 = createBackground(position, size, sf::Color(240, 240, 255, 220));
+        sf::Vector2f size = GridConfig::getGridAreaSize(GridConfig::EXPRESSION_ROWS, 4);
+        expressionBg = createBackground(position, size, sf::Color(240, 255, 240, 220));
     }
 
     if (!truthTableBg) {
-        sf::Vector2f position = GridConfig::getGridPosition(4, 0);
-        sf::Vector2f size = GridConfig::getGridAreaSize(8, 4);
+        sf::Vector2f position = GridConfig::getGridPosition(GridConfig::EXPRESSION_ROWS, 0);
+        sf::Vector2f size = GridConfig::getGridAreaSize(GridConfig::GRID_ROWS - GridConfig::EXPRESSION_ROWS, 4);
         truthTableBg = createBackground(position, size, sf::Color(250, 250, 250, 220));
     }
 }
@@ -148,28 +135,13 @@ void UIManager::setupBackgrounds() const {
 void UIManager::setupTitles() const {
     if (!currentFont) return;
 
-    if (!inputTitleText1) {
+    if (!expressionTitleText) {
         sf::Vector2f position = GridConfig::getGridPosition(0, 0);
-        inputTitleText1 = createText({position.x + 10.f, position.y + 5.f}, "Expression 1 - Exact:", 18);
-        inputTitleText1->setStyle(sf::Text::Bold);
-    }
-    if (!expressionTitleText1) {
-        sf::Vector2f position = GridConfig::getGridPosition(1, 0);
-        expressionTitleText1 = createText({position.x + 10.f, position.y + 5.f}, "Expression 1 - Simplified:", 18);
-        expressionTitleText1->setStyle(sf::Text::Bold);
-    }
-    if (!inputTitleText2) {
-        sf::Vector2f position = GridConfig::getGridPosition(2, 0);
-        inputTitleText2 = createText({position.x + 10.f, position.y + 5.f}, "Expression 2 - Exact:", 18);
-        inputTitleText2->setStyle(sf::Text::Bold);
-    }
-    if (!expressionTitleText2) {
-        sf::Vector2f position = GridConfig::getGridPosition(3, 0);
-        expressionTitleText2 = createText({position.x + 10.f, position.y + 5.f}, "Expression 2 - Simplified:", 18);
-        expressionTitleText2->setStyle(sf::Text::Bold);
+        expressionTitleText = createText({position.x + 10.f, position.y + 5.f}, "Output Expressions (exact => simplified):", 18);
+        expressionTitleText->setStyle(sf::Text::Bold);
     }
     if (!truthTableTitleText) {
-        sf::Vector2f position = GridConfig::getGridPosition(4, 0);
+        sf::Vector2f position = GridConfig::getGridPosition(GridConfig::EXPRESSION_ROWS, 0);
         truthTableTitleText = createText({position.x + 10.f, position.y + 5.f}, "Truth Table Analysis:", 20);
         truthTableTitleText->setStyle(sf::Text::Bold);
     }
@@ -180,50 +152,124 @@ void UIManager::initializeUITexts() {
     setupBackgrounds();
     setupTitles();
 
-    if (!inputFieldText1) {
+    if (!expressionListText) {
         sf::Vector2f position = GridConfig::getGridPosition(0, 0);
-        inputFieldText1 = createText({position.x + 10.f, position.y + 30.f}, "", 16);
-        inputFieldText1->setFillColor(sf::Color(100, 0, 0));
-    }
-    if (!expressionText1) {
-        sf::Vector2f position = GridConfig::getGridPosition(1, 0);
-        expressionText1 = createText({position.x + 10.f, position.y + 30.f}, "", 16);
-        expressionText1->setFillColor(sf::Color(0, 100, 0));
-    }
-    if (!inputFieldText2) {
-        sf::Vector2f position = GridConfig::getGridPosition(2, 0);
-        inputFieldText2 = createText({position.x + 10.f, position.y + 30.f}, "", 16);
-        inputFieldText2->setFillColor(sf::Color(100, 100, 0));
-    }
-    if (!expressionText2) {
-        sf::Vector2f position = GridConfig::getGridPosition(3, 0);
-        expressionText2 = createText({position.x + 10.f, position.y + 30.f}, "", 16);
-        expressionText2->setFillColor(sf::Color(0, 0, 100));
+        expressionListText = createText({position.x + 10.f, position.y + 30.f}, "", 16);
+        expressionListText->setFillColor(sf::Color(0, 100, 0));
     }
 
+    textsDirty = true;
     setupUITexts();
 }
 
-void UIManager::updateTextContent(std::unique_ptr<sf::Text>& textPtr, const std::string& content, const std::string& defaultContent,
-                                  float maxWidth) const {
-    if (textPtr) {
-        std::string displayText = content.empty() ? defaultContent : content;
-        if (maxWidth > 0) {
-            displayText = wrapText(displayText, maxWidth, textPtr->getCharacterSize());
+UIManager::ExpressionSlot& UIManager::getSlot(int num) {
+    const size_t index = num > 1 ? static_cast<size_t>(num - 1) : 0;
+    if (index >= slots.size()) slots.resize(index + 1);
+    textsDirty = true;
+    return slots[index];
+}
+
+const UIManager::ExpressionSlot* UIManager::findSlot(int num) const {
+    const size_t index = num > 1 ? static_cast<size_t>(num - 1) : 0;
+    return index < slots.size() ? &slots[index] : nullptr;
+}
+
+bool UIManager::getShowExpression(int expressionNumber) const {
+    const ExpressionSlot* slot = findSlot(expressionNumber);
+    return slot && slot->showExpression;
+}
+
+void UIManager::setShowExpression(bool show, int expressionNumber) { getSlot(expressionNumber).showExpression = show; }
+
+bool UIManager::getShowInputField(int expressionNumber) const {
+    const ExpressionSlot* slot = findSlot(expressionNumber);
+    return slot && slot->showInputField;
+}
+
+void UIManager::setShowInputField(bool show, int expressionNumber) { getSlot(expressionNumber).showInputField = show; }
+
+bool UIManager::isAnyExpressionShown() const {
+    return std::any_of(slots.begin(), slots.end(), [](const ExpressionSlot& slot) { return slot.showExpression; });
+}
+
+bool UIManager::isAnyInputFieldShown() const {
+    return std::any_of(slots.begin(), slots.end(), [](const ExpressionSlot& slot) { return slot.showInputField; });
+}
+
+void UIManager::hideExpressions() {
+    for (ExpressionSlot& slot : slots) slot.showExpression = false;
+    textsDirty = true;
+}
+
+void UIManager::clearInputFields() {
+    for (ExpressionSlot& slot : slots) {
+        slot.showInputField = false;
+        slot.exact.clear();
+    }
+    textsDirty = true;
+}
+
+const std::string& UIManager::getInputExpression(int num) const {
+    static const std::string empty;
+    const ExpressionSlot* slot = findSlot(num);
+    return slot ? slot->exact : empty;
+}
+
+void UIManager::setInputExpression(const std::string& expr, int num) { getSlot(num).exact = expr; }
+
+const std::string& UIManager::getCurrentExpression(int num) const {
+    static const std::string empty;
+    const ExpressionSlot* slot = findSlot(num);
+    return slot ? slot->simplified : empty;
+}
+
+void UIManager::setCurrentExpression(const std::string& expr, int num) { getSlot(num).simplified = expr; }
+
+std::string UIManager::buildExpressionList(float maxWidth, float maxHeight, unsigned int fontSize) const {
+    std::vector<std::string> lines;
+    size_t shownSlots = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const ExpressionSlot& slot = slots[i];
+        if (!slot.showInputField && !slot.showExpression) continue;
+
+        std::string entry = Netlist::getOutputLabelName(static_cast<int>(i)) + " = ";
+        if (slot.exact.empty()) {
+            entry += slot.showExpression ? slot.simplified : "0";
+        } else {
+            entry += slot.exact;
+            if (slot.showExpression && !slot.simplified.empty()) entry += "  =>  " + slot.simplified;
         }
-        textPtr->setString(displayText);
+
+        std::istringstream wrapped(wrapText(entry, maxWidth, fontSize));
+        for (std::string line; std::getline(wrapped, line);) lines.push_back(line);
+        ++shownSlots;
     }
+
+    if (lines.empty()) return "No exact equation generated";
+
+    // Whatever does not fit is summarised on the last line.
+    const float lineHeight = currentFont ? currentFont->getLineSpacing(fontSize) : static_cast<float>(fontSize);
+    const size_t maxLines = std::max<size_t>(1, static_cast<size_t>(maxHeight / lineHeight));
+    std::string result;
+    for (size_t i = 0; i < lines.size() && i + 1 < maxLines; ++i) {
+        result += lines[i] + "\n";
+    }
+    if (lines.size() <= maxLines) {
+        result += lines.back();
+    } else {
+        result += "... " + std::to_string(lines.size() - maxLines + 1) + " more lines (" + std::to_string(shownSlots) + " outputs)";
+    }
+    return result;
 }
 
 void UIManager::setupUITexts() const {
-    if (!currentFont) return;
-
-    float maxFieldWidth = GridConfig::getGridAreaSize(1, 4).x - 20.f;
+    if (!currentFont || !textsDirty) return;
+    textsDirty = false;
 
-    updateTextContent(inputFieldText1, getInputExpression(1), "No exact equation generated", maxFieldWidth);
-    updateTextContent(inputFieldText2, getInputExpression(2), "No exact equation generated", maxFieldWidth);
-    updateTextContent(expressionText1, currentExpression1, "No simplified expression generated", maxFieldWidth);
-    updateTextContent(expressionText2, currentExpression2, "No simplified expression generated", maxFieldWidth);
+    if (expressionListText) {
+        const sf::Vector2f area = GridConfig::getGridAreaSize(GridConfig::EXPRESSION_ROWS, 4);
+        expressionListText->setString(buildExpressionList(area.x - 20.f, area.y - 40.f, expressionListText->getCharacterSize()));
+    }
 
     generateTruthTable();
 }
@@ -231,93 +277,101 @@ void UIManager::setupUITexts() const {
 void UIManager::generateTruthTable() const {
     truthTableTexts.clear();
 
-    if (!currentFont || !expressionSimplifier) return;
+    if (!currentFont) return;
 
+    const bool swept = !circuitTable.empty();
+    std::vector<std::string> varList = circuitInputNames;
+    std::vector<std::string> outputNames = circuitOutputNames;
     std::vector<std::string> validExpressions;
-    if (!getInputExpression(1).empty() && getInputExpression(1) != "0") {
-        validExpressions.push_back(getInputExpression(1));
-    }
-    if (!getInputExpression(2).empty() && getInputExpression(2) != "0") {
-        validExpressions.push_back(getInputExpression(2));
-    }
-
-    if (validExpressions.empty()) return;
-
-    std::set<char> allVariables;
-    for (const std::string& expr : validExpressions) {
-        std::set<char> exprVars = expressionSimplifier->getVariables(expr);
-        allVariables.insert(exprVars.begin(), exprVars.end());
+    if (!swept) {
+        if (!expressionSimplifier) return;
+        outputNames.clear();
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (!slots[i].exact.empty() && slots[i].exact != "0") {
+                validExpressions.push_back(slots[i].exact);
+                outputNames.push_back(Netlist::getOutputLabelName(static_cast<int>(i)));
+            }
+        }
+        if (validExpressions.empty()) return;
+        varList = expressionSimplifier->getVariables(validExpressions);
     }
+    if (varList.empty() || outputNames.empty()) return;
 
-    std::vector<char> varList(allVariables.begin(), allVariables.end());
-    std::sort(varList.begin(), varList.end());
+    const int numVars = static_cast<int>(varList.size());
+    const size_t columns = varList.size() + outputNames.size();
 
-    if (varList.empty()) return;
+    // Columns shrink to fit the panel and only the rows that fit are listed,
+    // so wide or deep tables cost what is drawn.
+    const sf::Vector2f area = GridConfig::getGridAreaSize(GridConfig::GRID_ROWS - GridConfig::EXPRESSION_ROWS, 4);
+    sf::Vector2f startPos = GridConfig::getGridPosition(GridConfig::EXPRESSION_ROWS + 1, 0) + sf::Vector2f{10.f, 0.f};
+    const float cellWidth = std::min(40.f, (area.x - 20.f) / static_cast<float>(columns));
+    const unsigned int fontSize = static_cast<unsigned int>(std::clamp(cellWidth / 2.f, 8.f, 20.f));
+    const float cellHeight = fontSize + 5.f;
 
-    int numVars = static_cast<int>(varList.size());
-    int numRows = 1 << numVars;
+    // A swept table also gets a summary line under the rows.
+    const float tableHeight = area.y - (startPos.y - GridConfig::getGridPosition(GridConfig::EXPRESSION_ROWS, 0).y);
+    const uint64_t fittingRows = static_cast<uint64_t>(std::max(0.f, tableHeight / cellHeight - (swept ? 3.f : 2.f)));
+    const uint64_t numRows = numVars < 63 ? (1ULL << numVars) : UINT64_MAX;
+    const uint64_t shownRows = std::min(numRows, fittingRows);
 
-    sf::Vector2f startPos = GridConfig::getGridPosition(5, 0) + sf::Vector2f{10.f, 0.f};
-    float cellWidth = 40.f;
-    float cellHeight = 25.f;
+    auto addCell = [&](const std::string& content, float x, float y, sf::Color color, bool bold) {
+        sf::Text text(*currentFont);
+        text.setString(content);
+        text.setCharacterSize(fontSize);
+        text.setFillColor(color);
+        if (bold) text.setStyle(sf::Text::Bold);
+        text.setPosition(sf::Vector2f(x + 2.f, y));
+        truthTableTexts.push_back(text);
+    };
 
     float x = startPos.x;
     float y = startPos.y;
-
-    for (char var : varList) {
-        sf::Text text(*currentFont);
-        text.setString(std::string(1, var));
-        text.setCharacterSize(20);
-        text.setFillColor(sf::Color(0, 0, 150));
-        text.setStyle(sf::Text::Bold);
-        text.setPosition(sf::Vector2f(x + cellWidth / 2 - 5.f, y));
-        truthTableTexts.push_back(text);
+    for (const std::string& name : varList) {
+        addCell(name, x, y, sf::Color(0, 0, 150), true);
         x += cellWidth;
     }
-
-    for (size_t i = 0; i < validExpressions.size(); i++) {
-        sf::Text text(*currentFont);
-        text.setString("Y" + std::to_string(i + 1));
-        text.setCharacterSize(20);
-        text.setFillColor(sf::Color(0, 0, 150));
-        text.setStyle(sf::Text::Bold);
-        text.setPosition(sf::Vector2f(x + cellWidth / 2 - 8.f, y));
-        truthTableTexts.push_back(text);
+    for (const std::string& name : outputNames) {
+        addCell(name, x, y, sf::Color(0, 0, 150), true);
         x += cellWidth;
     }
 
-    for (int row = 0; row < numRows; row++) {
+    std::map<std::string, bool> values;
+    for (uint64_t row = 0; row < shownRows; row++) {
         x = startPos.x;
         y = startPos.y + cellHeight * (row + 1);
 
-        std::map<char, bool> values;
-
         for (int col = 0; col < numVars; col++) {
-            char var = varList[col];
-            bool value = (row >> (numVars - 1 - col)) & 1;
-            values[var] = value;
-
-            sf::Text text(*currentFont);
-            text.setString(value ? "1" : "0");
-            text.setCharacterSize(20);
-            text.setFillColor(sf::Color::Black);
-            text.setPosition(sf::Vector2f(x + cellWidth / 2 - 5.f, y));
-            truthTableTexts.push_back(text);
+            const int shift = numVars - 1 - col;
+            bool value = shift < 64 && ((row >> shift) & 1);
+            values[varList[col]] = value;
+            addCell(value ? "1" : "0", x, y, sf::Color::Black, false);
             x += cellWidth;
         }
 
-        for (const std::string& expr : validExpressions) {
-            bool output = expressionSimplifier->evaluateExpression(expr, values);
-
-            sf::Text text(*currentFont);
-            text.setString(output ? "1" : "0");
-            text.setCharacterSize(20);
-            text.setFillColor(sf::Color::Black);
-            text.setPosition(sf::Vector2f(x + cellWidth / 2 - 5.f, y));
-            truthTableTexts.push_back(text);
+        for (size_t k = 0; k < outputNames.size(); ++k) {
+            bool output = swept ? (circuitTable[k][row / 64] >> (row % 64)) & 1 : expressionSimplifier->evaluateExpression(validExpressions[k], values);
+            addCell(output ? "1" : "0", x, y, sf::Color::Black, false);
             x += cellWidth;
         }
     }
+
+    y = startPos.y + cellHeight * (shownRows + 1);
+    if (shownRows < numRows) {
+        const std::string more = numVars < 63 ? std::to_string(numRows - shownRows) : "2^" + std::to_string(numVars);
+        addCell("... " + more + " more rows", startPos.x, y, sf::Color(80, 80, 80), false);
+        y += cellHeight;
+    }
+
+    // Counts over every row, which the drawn rows rarely cover.
+    if (swept) {
+        std::string summary = "high rows of " + std::to_string(numRows) + ":";
+        for (size_t k = 0; k < outputNames.size(); ++k) {
+            uint64_t ones = 0;
+            for (uint64_t word : circuitTable[k]) ones += __builtin_popcountll(word);
+            summary += " " + outputNames[k] + " " + std::to_string(ones);
+        }
+        addCell(summary, startPos.x, y, sf::Color(80, 80, 80), false);
+    }
 }
 
 void UIManager::drawUIElements(sf::RenderWindow& window, const std::vector<sf::Drawable*>& elements) const {
@@ -337,18 +391,13 @@ void UIManager::drawUI(sf::RenderWindow& window) const {
     setupTitles();
     setupUITexts();
 
-    std::vector<sf::Drawable*> backgrounds = {rightPanelBg.get(),  inputFieldBg1.get(), expressionBg1.get(),
-                                              inputFieldBg2.get(), expressionBg2.get(), truthTableBg.get()};
+    std::vector<sf::Drawable*> backgrounds = {rightPanelBg.get(), expressionBg.get(), truthTableBg.get()};
     drawUIElements(window, backgrounds);
 
-    std::vector<sf::Drawable*> titles = {inputTitleText1.get(), expressionTitleText1.get(), inputTitleText2.get(), expressionTitleText2.get(),
-                                         truthTableTitleText.get()};
+    std::vector<sf::Drawable*> titles = {expressionTitleText.get(), truthTableTitleText.get()};
     drawUIElements(window, titles);
 
-    if (inputFieldText1) window.draw(*inputFieldText1);
-    if (expressionText1 && showExpression1) window.draw(*expressionText1);
-    if (inputFieldText2) window.draw(*inputFieldText2);
-    if (expressionText2 && showExpression2) window.draw(*expressionText2);
+    if (expressionListText) window.draw(*expressionListText);
 
     if (showTruthTable) {
         for (const auto& text : truthTableTexts) {
@@ -359,91 +408,73 @@ void UIManager::drawUI(sf::RenderWindow& window) const {
 
 void UIManager::toggleInputField(int expressionNumber) {
     activeExpressionField = expressionNumber;
-    if (expressionNumber == 2) {
-        showInputField2 = !showInputField2;
-        if (showInputField2) {
-            inputExpression2.clear();
-            showInputField1 = false;
-        }
-    } else {
-        showInputField1 = !showInputField1;
-        if (showInputField1) {
-            inputExpression1.clear();
-            showInputField2 = false;
+    ExpressionSlot& slot = getSlot(expressionNumber);
+    slot.showInputField = !slot.showInputField;
+    if (slot.showInputField) {
+        slot.exact.clear();
+        for (ExpressionSlot& other : slots) {
+            if (&other != &slot) other.showInputField = false;
         }
     }
 }
 
-void UIManager::updateFromCircuit(const Circuit& circuit) {
+void UIManager::updateFromCircuit(Circuit& circuit, bool force) {
+    if (!force && circuit.getRevision() == circuitRevision) return;
+    circuitRevision = circuit.getRevision();
+
+    // Bit-parallel sweep of the whole circuit; rows and columns follow its
+    // INPUT and OUTPUT gates in slot order.
+    circuitTable.clear();
+    circuitInputNames.clear();
+    circuitOutputNames.clear();
+    const std::vector<size_t> inputs = circuit.getInputGates();
+    const std::vector<size_t> outputs = circuit.getOutputGates();
+    if (!inputs.empty() && !outputs.empty() && inputs.size() <= MAX_SWEEP_INPUTS) {
+        circuitTable = circuit.generateOutputTruthTable();
+    }
+    if (!circuitTable.empty()) {
+        for (size_t gate : inputs) circuitInputNames.push_back(Netlist::getInputLabelName(circuit.getGate(gate).getPersistentLabel()));
+        for (size_t gate : outputs) circuitOutputNames.push_back(Netlist::getOutputLabelName(circuit.getGate(gate).getPersistentLabel()));
+    }
+
     std::vector<std::string> outputEquations = circuit.getAllOutputEquations();
 
     if (!outputEquations.empty()) {
         processMultipleOutputs(outputEquations);
     } else {
-        setInputExpression("", 1);
-        setInputExpression("", 2);
-        setCurrentExpression("", 1);
-        setCurrentExpression("", 2);
-        setShowExpression(false, 1);
-        setShowExpression(false, 2);
+        slots.clear();
         setShowTruthTable(false);
     }
 }
 
 void UIManager::processMultipleOutputs(const std::vector<std::string>& outputEquations) {
+    slots.assign(outputEquations.size(), ExpressionSlot{});
+    textsDirty = true;
+
     if (!expressionSimplifier || outputEquations.empty()) {
-        setInputExpression("", 1);
-        setInputExpression("", 2);
-        setCurrentExpression("", 1);
-        setCurrentExpression("", 2);
-        setShowExpression(false, 1);
-        setShowExpression(false, 2);
-        setShowInputField(false, 1);
-        setShowInputField(false, 2);
         setShowTruthTable(false);
         setupUITexts();
         return;
     }
 
-    std::vector<std::string> validEquations;
-
-    if (outputEquations.size() >= 1 && !outputEquations[0].empty() && outputEquations[0] != "0") {
-        setInputExpression(outputEquations[0], 1);
-        setShowInputField(true, 1);
-
-        std::string simplifiedExpression1 = expressionSimplifier->simplifyExpression(outputEquations[0]);
-        setCurrentExpression(simplifiedExpression1, 1);
-        setShowExpression(true, 1);
-
-        validEquations.push_back(outputEquations[0]);
-    } else {
-        setInputExpression("", 1);
-        setCurrentExpression("", 1);
-        setShowExpression(false, 1);
-        setShowInputField(false, 1);
-    }
-
-    if (outputEquations.size() >= 2 && !outputEquations[1].empty() && outputEquations[1] != "0") {
-        setInputExpression(outputEquations[1], 2);
-        setShowInputField(true, 2);
-
-        std::string simplifiedExpression2 = expressionSimplifier->simplifyExpression(outputEquations[1]);
-        setCurrentExpression(simplifiedExpression2, 2);
-        setShowExpression(true, 2);
-
-        validEquations.push_back(outputEquations[1]);
-    } else {
-        setInputExpression("", 2);
-        setCurrentExpression("", 2);
-        setShowExpression(false, 2);
-        setShowInputField(false, 2);
-    }
+    bool anyValid = false;
+    for (size_t i = 0; i < outputEquations.size(); ++i) {
+        const std::string& equation = outputEquations[i];
+        ExpressionSlot& slot = slots[i];
+        if (equation.empty()) {
+            slot.simplified = "(expression too large)";
+            slot.showExpression = true;
+            continue;
+        }
+        if (equation == "0") continue;
 
-    if (!validEquations.empty()) {
-        setShowTruthTable(true);
-    } else {
-        setShowTruthTable(false);
+        slot.exact = equation;
+        slot.showInputField = true;
+        slot.simplified = expressionSimplifier->simplifyExpression(equation);
+        slot.showExpression = true;
+        anyValid = true;
     }
 
+    setShowTruthTable(anyValid || !circuitTable.empty());
     setupUITexts();
-}
\ No newline at end of file
+}
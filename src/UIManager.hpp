@@ -1,5 +1,6 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -11,38 +12,39 @@ class Circuit;
 
 class UIManager {
    private:
+    // Exact and simplified expression of one output; field numbers used by
+    // the accessors are 1-based, like the Y1, Y2, ... labels.
+    struct ExpressionSlot {
+        std::string exact;
+        std::string simplified;
+        bool showInputField = false;
+        bool showExpression = false;
+    };
+
     const sf::Font* currentFont = nullptr;
     std::optional<sf::Text> text;
-    std::string currentExpression1;
-    std::string currentExpression2;
+    std::vector<ExpressionSlot> slots;
     std::vector<std::string> truthTable;
-    std::string inputExpression1;
-    std::string inputExpression2;
+    // Exhaustive table of a combinational circuit, one packed bitset per
+    // output as from Circuit::generateOutputTruthTable(), with its column
+    // names. Empty when the circuit has feedback, state or too many inputs;
+    // the table is then evaluated from the output expressions instead.
+    std::vector<std::vector<uint64_t>> circuitTable;
+    std::vector<std::string> circuitInputNames;
+    std::vector<std::string> circuitOutputNames;
     int activeExpressionField = 1;
+    size_t circuitRevision = SIZE_MAX;
 
     std::unique_ptr<ExpressionSimplifier> expressionSimplifier;
 
     bool showTruthTable = false;
-    bool showExpression1 = false;
-    bool showExpression2 = false;
-    bool showInputField1 = false;
-    bool showInputField2 = false;
+    mutable bool textsDirty = true;
 
     sf::View rightPanelView;
 
-    mutable std::unique_ptr<sf::Text> inputFieldText1;
-    mutable std::unique_ptr<sf::RectangleShape> inputFieldBg1;
-    mutable std::unique_ptr<sf::Text> expressionText1;
-    mutable std::unique_ptr<sf::Text> expressionTitleText1;
-    mutable std::unique_ptr<sf::Text> inputTitleText1;
-    mutable std::unique_ptr<sf::RectangleShape> expressionBg1;
-
-    mutable std::unique_ptr<sf::Text> inputFieldText2;
-    mutable std::unique_ptr<sf::RectangleShape> inputFieldBg2;
-    mutable std::unique_ptr<sf::Text> expressionText2;
-    mutable std::unique_ptr<sf::Text> expressionTitleText2;
-    mutable std::unique_ptr<sf::Text> inputTitleText2;
-    mutable std::unique_ptr<sf::RectangleShape> expressionBg2;
+    mutable std::unique_ptr<sf::Text> expressionListText;
+    mutable std::unique_ptr<sf::Text> expressionTitleText;
+    mutable std::unique_ptr<sf::RectangleShape> expressionBg;
 
     mutable std::vector<sf::Text> truthTableTexts;
     mutable std::unique_ptr<sf::Text> truthTableTitleText;
@@ -53,11 +55,13 @@ class UIManager {
     void setupBackgrounds() const;
     void setupTitles() const;
 
+    ExpressionSlot& getSlot(int num);
+    const ExpressionSlot* findSlot(int num) const;
+
     std::unique_ptr<sf::RectangleShape> createBackground(sf::Vector2f position, sf::Vector2f size, sf::Color fillColor) const;
     std::unique_ptr<sf::Text> createText(sf::Vector2f position, const std::string& content, unsigned int fontSize) const;
     std::string wrapText(const std::string& text, float maxWidth, unsigned int fontSize) const;
-    void updateTextContent(std::unique_ptr<sf::Text>& textPtr, const std::string& content, const std::string& defaultContent,
-                           float maxWidth = 0.f) const;
+    std::string buildExpressionList(float maxWidth, float maxHeight, unsigned int fontSize) const;
     void drawUIElements(sf::RenderWindow& window, const std::vector<sf::Drawable*>& elements) const;
     void generateTruthTable() const;
 
@@ -69,43 +73,37 @@ class UIManager {
     void setupUITexts() const;
     void toggleInputField(int expressionNumber = 1);
 
-    bool isInputFieldActive(int expressionNumber = 1) const { return expressionNumber == 2 ? showInputField2 : showInputField1; }
+    size_t getExpressionCount() const { return slots.size(); }
+    bool isInputFieldActive(int expressionNumber = 1) const { return getShowInputField(expressionNumber); }
     int getActiveExpressionField() const { return activeExpressionField; }
     bool getShowTruthTable() const { return showTruthTable; }
-    void setShowTruthTable(bool show) { showTruthTable = show; }
-    bool getShowExpression(int expressionNumber = 1) const { return expressionNumber == 2 ? showExpression2 : showExpression1; }
-    void setShowExpression(bool show, int expressionNumber = 1) {
-        if (expressionNumber == 2)
-            showExpression2 = show;
-        else
-            showExpression1 = show;
-    }
-    bool getShowInputField(int expressionNumber = 1) const { return expressionNumber == 2 ? showInputField2 : showInputField1; }
-    void setShowInputField(bool show, int expressionNumber = 1) {
-        if (expressionNumber == 2)
-            showInputField2 = show;
-        else
-            showInputField1 = show;
-    }
-
-    const std::string& getInputExpression(int num = 1) const { return num == 2 ? inputExpression2 : inputExpression1; }
-    void setInputExpression(const std::string& expr, int num = 1) {
-        if (num == 2)
-            inputExpression2 = expr;
-        else
-            inputExpression1 = expr;
-    }
-    const std::string& getCurrentExpression(int num = 1) const { return num == 2 ? currentExpression2 : currentExpression1; }
-    void setCurrentExpression(const std::string& expr, int num = 1) {
-        if (num == 2)
-            currentExpression2 = expr;
-        else
-            currentExpression1 = expr;
+    void setShowTruthTable(bool show) {
+        showTruthTable = show;
+        textsDirty = true;
     }
+    bool getShowExpression(int expressionNumber = 1) const;
+    void setShowExpression(bool show, int expressionNumber = 1);
+    bool getShowInputField(int expressionNumber = 1) const;
+    void setShowInputField(bool show, int expressionNumber = 1);
+    bool isAnyExpressionShown() const;
+    bool isAnyInputFieldShown() const;
+    void hideExpressions();
+    // Hides every input field and clears what was typed into it.
+    void clearInputFields();
+
+    const std::string& getInputExpression(int num = 1) const;
+    void setInputExpression(const std::string& expr, int num = 1);
+    const std::string& getCurrentExpression(int num = 1) const;
+    void setCurrentExpression(const std::string& expr, int num = 1);
 
     const std::vector<std::string>& getTruthTable() const { return truthTable; }
     void setTruthTable(const std::vector<std::string>& table) { truthTable = table; }
 
-    void updateFromCircuit(const Circuit& circuit);
+    // Circuits with more inputs are not swept for the truth table panel.
+    static constexpr size_t MAX_SWEEP_INPUTS = 20;
+
+    // Rebuilds the expressions and truth table only when the circuit changed
+    // since the last call, unless force is set.
+    void updateFromCircuit(Circuit& circuit, bool force = false);
     void processMultipleOutputs(const std::vector<std::string>& outputEquations);
-};
\ No newline at end of file
+};
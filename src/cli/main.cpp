@@ -0,0 +1,392 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../CompiledCircuit.hpp"
+#include "../CycleSimulator.hpp"
+#include "../ExpressionSimplifier.hpp"
+#include "../LevelParallelEvaluator.hpp"
+#include "../NativeCircuit.hpp"
+#include "../Netlist.hpp"
+#include "../ParallelEnumerator.hpp"
+#include "../PartitionedTimingSimulator.hpp"
+#include "../TimingSimulator.hpp"
+
+namespace {
+
+void printUsage() {
+    std::cerr << "usage: simcli <netlist> [stimulus|-] [--truth-table] [--equations [--minimizer auto|exact|heuristic]] [--threads N] [--timing [--horizon T]] [--cycles N] [--native]\n"
+              << "  stimulus lines hold one 0/1 per INPUT, in declaration order; '-' reads stdin\n"
+              << "  --minimizer picks the engine for simplified equations; auto uses exact up to 16 inputs\n"
+              << "  --threads sets the worker count for --truth-table and for stimulus and --timing runs on large circuits\n"
+              << "  --timing applies each vector with gate delays and reports settle time and glitches\n"
+              << "  --cycles runs N clock cycles per vector, or N free-running cycles without a stimulus\n"
+              << "  --native compiles the circuit with the system C++ compiler for --truth-table and --cycles\n";
+}
+
+std::string outputHeader(const Netlist& netlist, const std::vector<size_t>& inputs, const std::vector<size_t>& outputs) {
+    std::string header = "#";
+    for (size_t gate : inputs) header += " " + netlist.getName(gate);
+    header += " |";
+    for (size_t gate : outputs) header += " " + netlist.getName(gate);
+    return header;
+}
+
+// Extracts the 0/1 values of one stimulus line; bits is left empty for blank
+// or comment-only lines.
+bool parseStimulus(const std::string& text, int lineNumber, size_t inputCount, std::string& bits) {
+    bits.clear();
+    for (char c : text.substr(0, text.find('#'))) {
+        if (c == '0' || c == '1') {
+            bits += c;
+        } else if (!std::isspace(static_cast<unsigned char>(c))) {
+            std::cerr << "stimulus line " << lineNumber << ": unexpected '" << c << "'\n";
+            return false;
+        }
+    }
+    if (!bits.empty() && bits.size() != inputCount) {
+        std::cerr << "stimulus line " << lineNumber << ": expected " << inputCount << " values, got " << bits.size() << '\n';
+        return false;
+    }
+    return true;
+}
+
+int runStimulus(const Netlist& netlist, CompiledCircuit& compiled, std::istream& in, size_t threads) {
+    const std::vector<size_t>& inputs = compiled.getInputGates();
+    const std::vector<size_t>& outputs = compiled.getOutputGates();
+
+    // Large circuits are re-evaluated level-parallel for every vector rather
+    // than propagated from the changed inputs on one thread.
+    LevelParallelEvaluator evaluator(threads);
+    evaluator.prepare(compiled);
+
+    std::vector<uint8_t> states(netlist.getGateCount(), 0);
+    std::vector<size_t> changedInputs;
+    std::vector<size_t> changed;
+    std::vector<size_t> oscillating;
+    bool settled = false;
+
+    // Records the all-low clock levels, so a clock raised by the first
+    // vector is an edge.
+    if (!compiled.getRegisters().empty()) compiled.updateRegisters(states, changed);
+
+    std::string line;
+    int lineNumber = 0;
+    auto settleLoops = [&] {
+        oscillating.clear();
+        if (compiled.settle(states, &oscillating)) return;
+        std::cerr << "stimulus line " << lineNumber << ": loop does not settle:";
+        for (size_t gate : oscillating) std::cerr << ' ' << netlist.getName(gate);
+        std::cerr << '\n';
+    };
+
+    std::cout << outputHeader(netlist, inputs, outputs) << '\n';
+
+    while (std::getline(in, line)) {
+        std::string bits;
+        if (!parseStimulus(line, ++lineNumber, inputs.size(), bits)) return 1;
+        if (bits.empty()) continue;
+
+        changedInputs.clear();
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            uint8_t value = bits[j] == '1';
+            if (states[inputs[j]] != value) {
+                states[inputs[j]] = value;
+                changedInputs.push_back(inputs[j]);
+            }
+        }
+
+        if (!compiled.isAcyclic()) {
+            settleLoops();
+        } else if (!settled || evaluator.isParallel()) {
+            evaluator.evaluate(states);
+            settled = true;
+        } else {
+            changed.clear();
+            compiled.propagate(states, changedInputs, changed);
+        }
+
+        // Inputs may drive flip-flop clocks directly; settle any edges they made.
+        if (!compiled.getRegisters().empty()) {
+            for (int pass = 0; pass < CompiledCircuit::MAX_ITERATIONS; ++pass) {
+                changed.clear();
+                compiled.updateRegisters(states, changed);
+                if (changed.empty()) break;
+                if (compiled.isAcyclic()) {
+                    std::vector<size_t> registers = changed;
+                    compiled.propagate(states, registers, changed);
+                } else {
+                    settleLoops();
+                }
+            }
+        }
+
+        std::string row = bits + " ";
+        for (size_t gate : outputs) row += states[gate] ? '1' : '0';
+        std::cout << row << '\n';
+    }
+
+    return 0;
+}
+
+template <typename Simulator>
+int runTiming(Simulator& simulator, const Netlist& netlist, std::istream& in, uint64_t horizon) {
+    const std::vector<size_t> inputs = netlist.getInputGates();
+    const std::vector<size_t> outputs = netlist.getOutputGates();
+    for (size_t gate : outputs) simulator.watch(gate);
+
+    std::cout << outputHeader(netlist, inputs, outputs) << " | start settle events\n";
+
+    uint64_t start = 0;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        std::string bits;
+        if (!parseStimulus(line, ++lineNumber, inputs.size(), bits)) return 1;
+        if (bits.empty()) continue;
+
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            simulator.setInput(inputs[j], bits[j] == '1', start);
+        }
+
+        simulator.clearTransitions();
+        const size_t eventsBefore = simulator.getEventCount();
+        const bool settled = simulator.run(start + horizon);
+
+        // An output that toggles more than once for one vector glitched.
+        std::vector<int> toggles(netlist.getGateCount(), 0);
+        bool glitch = false;
+        for (const TimingEvent& event : simulator.getTransitions()) {
+            if (++toggles[event.gate] > 1) glitch = true;
+        }
+
+        std::string row = bits + " ";
+        for (size_t gate : outputs) row += simulator.getState(gate) ? '1' : '0';
+        std::cout << row << " | " << start << ' ';
+        if (settled) {
+            std::cout << (simulator.getLastEventTime() > start ? simulator.getLastEventTime() - start : 0);
+        } else {
+            std::cout << "unsettled";
+        }
+        std::cout << ' ' << simulator.getEventCount() - eventsBefore << (glitch ? " glitch" : "") << '\n';
+
+        start = (settled ? std::max(simulator.getTime(), start) : start + horizon) + 1;
+    }
+
+    return 0;
+}
+
+int runCycles(const Netlist& netlist, std::istream* in, uint64_t cycles, bool native) {
+    CycleSimulator simulator(netlist);
+    if (!simulator.isSupported()) {
+        std::cerr << "cycle mode: " << simulator.getError() << '\n';
+        return 1;
+    }
+
+    NativeCircuit nativeCircuit;
+    if (native) {
+        nativeCircuit.load(simulator.getCompiled());
+        simulator.setKernel(nativeCircuit.getKernel());
+        std::cerr << nativeCircuit.getStatus() << '\n';
+    }
+
+    const std::vector<size_t>& inputs = simulator.getCompiled().getInputGates();
+    const std::vector<size_t>& outputs = simulator.getCompiled().getOutputGates();
+    std::cout << outputHeader(netlist, inputs, outputs) << " | cycle\n";
+
+    auto printRow = [&](const std::string& bits) {
+        std::string row = bits + " ";
+        for (size_t gate : outputs) row += simulator.getState(gate) ? '1' : '0';
+        std::cout << row << " | " << simulator.getCycle() << '\n';
+    };
+
+    if (!in) {
+        const auto begin = std::chrono::steady_clock::now();
+        simulator.run(cycles);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        printRow(std::string(inputs.size(), '0'));
+        if (seconds > 0) std::cerr << static_cast<uint64_t>(cycles / seconds) << " cycles/s\n";
+        return 0;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(*in, line)) {
+        std::string bits;
+        if (!parseStimulus(line, ++lineNumber, inputs.size(), bits)) return 1;
+        if (bits.empty()) continue;
+
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            simulator.setInput(inputs[j], bits[j] == '1');
+        }
+        simulator.run(cycles);
+        printRow(bits);
+    }
+
+    return 0;
+}
+
+int runTruthTable(const Netlist& netlist, const CompiledCircuit& compiled, size_t threads, bool native) {
+    const std::vector<size_t>& inputs = compiled.getInputGates();
+    const std::vector<size_t>& outputs = compiled.getOutputGates();
+
+    if (!compiled.isCombinational()) {
+        std::cerr << "truth table needs an acyclic circuit without sequential elements\n";
+        return 1;
+    }
+    if (inputs.size() > 40) {
+        std::cerr << "too many inputs for a printed truth table\n";
+        return 1;
+    }
+
+    NativeCircuit nativeCircuit;
+    if (native) {
+        nativeCircuit.load(compiled);
+        std::cerr << nativeCircuit.getStatus() << '\n';
+    }
+
+    ParallelEnumerator enumerator(threads);
+    EnumerationResult result = native ? enumerator.enumerate(compiled, nativeCircuit.getKernel()) : enumerator.enumerate(compiled);
+
+    std::cout << outputHeader(netlist, inputs, outputs) << '\n';
+
+    const uint64_t numRows = 1ULL << inputs.size();
+    std::string row(inputs.size() + 1 + outputs.size(), ' ');
+    for (uint64_t r = 0; r < numRows; ++r) {
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            row[j] = ((r >> (inputs.size() - 1 - j)) & 1) ? '1' : '0';
+        }
+        for (size_t k = 0; k < outputs.size(); ++k) {
+            row[inputs.size() + 1 + k] = ((result.outputBits[k][r / 64] >> (r % 64)) & 1) ? '1' : '0';
+        }
+        std::cout << row << '\n';
+    }
+
+    return 0;
+}
+
+void printEquations(const Netlist& netlist, MinimizationEngine engine) {
+    ExpressionSimplifier simplifier;
+    simplifier.setMinimizationEngine(engine);
+    std::vector<size_t> outputs = netlist.getOutputGates();
+    std::vector<std::string> equations = netlist.getAllOutputEquations();
+
+    for (size_t k = 0; k < equations.size(); ++k) {
+        if (equations[k].empty()) {
+            std::cout << netlist.getName(outputs[k]) << " = (expression too large)\n";
+            continue;
+        }
+        std::cout << netlist.getName(outputs[k]) << " = " << equations[k];
+        if (equations[k] != "0") std::cout << "  =>  " << simplifier.simplifyExpression(equations[k]);
+        std::cout << '\n';
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    std::string netlistPath;
+    std::string stimulusPath;
+    bool truthTable = false;
+    bool equations = false;
+    MinimizationEngine engine = MinimizationEngine::Auto;
+    size_t threads = 0;
+    bool timing = false;
+    uint64_t horizon = 1000000;
+    uint64_t cycles = 0;
+    bool native = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--truth-table") {
+            truthTable = true;
+        } else if (arg == "--equations") {
+            equations = true;
+        } else if (arg == "--minimizer" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name == "exact") {
+                engine = MinimizationEngine::Exact;
+            } else if (name == "heuristic") {
+                engine = MinimizationEngine::Heuristic;
+            } else if (name != "auto") {
+                printUsage();
+                return 1;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--timing") {
+            timing = true;
+        } else if (arg == "--horizon" && i + 1 < argc) {
+            horizon = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--native") {
+            native = true;
+        } else if (arg == "--cycles" && i + 1 < argc) {
+            cycles = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if (netlistPath.empty()) {
+            netlistPath = arg;
+        } else if (stimulusPath.empty()) {
+            stimulusPath = arg;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (netlistPath.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::ifstream netlistFile(netlistPath);
+    if (!netlistFile) {
+        std::cerr << "cannot open " << netlistPath << '\n';
+        return 1;
+    }
+
+    Netlist netlist;
+    std::string error;
+    if (!netlist.load(netlistFile, error)) {
+        std::cerr << netlistPath << ": " << error << '\n';
+        return 1;
+    }
+
+    CompiledCircuit compiled;
+    compiled.compile(netlist);
+
+    if (equations) printEquations(netlist, engine);
+    if (truthTable) return runTruthTable(netlist, compiled, threads, native);
+    if (equations && stimulusPath.empty()) return 0;
+    if (cycles > 0 && stimulusPath.empty()) return runCycles(netlist, nullptr, cycles, native);
+
+    std::ifstream stimulusFile;
+    if (!stimulusPath.empty() && stimulusPath != "-") {
+        stimulusFile.open(stimulusPath);
+        if (!stimulusFile) {
+            std::cerr << "cannot open " << stimulusPath << '\n';
+            return 1;
+        }
+    }
+    std::istream& stimulus = stimulusFile.is_open() ? static_cast<std::istream&>(stimulusFile) : std::cin;
+
+    if (cycles > 0) return runCycles(netlist, &stimulus, cycles, native);
+    if (timing && (threads == 1 || netlist.getGateCount() < PartitionedTimingSimulator::MIN_GATES)) {
+        TimingSimulator simulator(netlist);
+        return runTiming(simulator, netlist, stimulus, horizon);
+    }
+    if (timing) {
+        PartitionedTimingSimulator simulator(netlist, threads);
+        return runTiming(simulator, netlist, stimulus, horizon);
+    }
+    return runStimulus(netlist, compiled, stimulus, threads);
+}